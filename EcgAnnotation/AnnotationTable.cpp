@@ -0,0 +1,69 @@
+#include <algorithm>
+#include "AnnotationTable.h"
+
+AnnotationView::AnnotationView() : _samples(nullptr), _types(nullptr), _aux(nullptr), _size(0)
+{
+}
+
+AnnotationView::AnnotationView(const AnnotationTable &table) : _samples(table.getSamples()), _types(table.getTypes()),
+_aux(table.getAux()), _size(table.getSize())
+{
+}
+
+AnnotationView::AnnotationView(const int *samples, const int *types, const int *aux, int size) : _samples(samples),
+_types(types), _aux(aux), _size(size)
+{
+}
+
+AnnotationView AnnotationView::subview(int from, int count) const
+{
+	from = std::max(0, std::min(from, _size));
+	if (count < 0 || count > _size - from)
+		count = _size - from;
+	return AnnotationView(_samples + from, _types + from, _aux + from, count);
+}
+
+
+AnnotationTable::AnnotationTable()
+{
+}
+
+void AnnotationTable::add(int sample, int type, int aux)
+{
+	_samples.push_back(sample);
+	_types.push_back(type);
+	_aux.push_back(aux);
+}
+
+void AnnotationTable::assign(AnnotationView rows)
+{
+	_samples.assign(rows.getSamples(), rows.getSamples() + rows.getSize());
+	_types.assign(rows.getTypes(), rows.getTypes() + rows.getSize());
+	_aux.assign(rows.getAux(), rows.getAux() + rows.getSize());
+}
+
+void AnnotationTable::reserve(int size)
+{
+	_samples.reserve(size_t(size));
+	_types.reserve(size_t(size));
+	_aux.reserve(size_t(size));
+}
+
+void AnnotationTable::resize(int size)
+{
+	_samples.resize(size_t(size), 0);
+	_types.resize(size_t(size), 0);
+	_aux.resize(size_t(size), -1);
+}
+
+void AnnotationTable::clear()
+{
+	_samples.clear();
+	_types.clear();
+	_aux.clear();
+}
+
+AnnotationView AnnotationTable::getView(int from, int count) const
+{
+	return AnnotationView(*this).subview(from, count);
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <vector>
+
+class AnnotationTable;
+
+//rows [from, from + size) of an AnnotationTable, not owned: valid while the table is not resized
+class AnnotationView
+{
+public:
+	AnnotationView();
+	AnnotationView(const AnnotationTable &table);        //all rows
+	AnnotationView(const int *samples, const int *types, const int *aux, int size);
+
+	// Operations
+	AnnotationView subview(int from, int count) const;
+
+	// Access
+	inline int sample(int i) const;
+	inline int type(int i) const;
+	inline int aux(int i) const;
+	inline int getSize() const;
+	inline bool empty() const;
+	inline const int* getSamples() const;
+	inline const int* getTypes() const;
+	inline const int* getAux() const;
+
+private:
+	const int *_samples;
+	const int *_types;
+	const int *_aux;
+	int _size;
+};
+
+//annotation rows kept as three contiguous columns: sample, type (anncodes index) and aux data index
+//(-1 no aux data). Move only, so a table has one owner
+class AnnotationTable
+{
+public:
+	AnnotationTable();
+	AnnotationTable(AnnotationTable&& table) = default;
+	AnnotationTable& operator=(AnnotationTable&& table) = default;
+
+	// Operations
+	void add(int sample, int type, int aux = -1);
+	void assign(AnnotationView rows);              //copy of rows of another table
+	void reserve(int size);
+	void resize(int size);                         //new rows 0, 0, -1
+	void clear();
+
+	// Access
+	inline int getSize() const;
+	inline bool empty() const;
+	inline int* getSamples();
+	inline int* getTypes();
+	inline int* getAux();
+	inline const int* getSamples() const;
+	inline const int* getTypes() const;
+	inline const int* getAux() const;
+	AnnotationView getView(int from = 0, int count = -1) const;   //count -1 to the last row
+
+private:
+	AnnotationTable(const AnnotationTable& table) = delete;
+	const AnnotationTable& operator=(const AnnotationTable& table) = delete;
+
+	std::vector<int> _samples;
+	std::vector<int> _types;
+	std::vector<int> _aux;
+};
+
+/*//////////////////////////////////////////////
+		AnnotationView ann = annotator.getAnnotation();
+		for (int i = 0; i < ann.getSize(); i++)
+			printf("%d %s\n", ann.sample(i), anncodes[ann.type(i)]);
+//////////////////////////////////////////////*/
+
+// Inlines
+inline int AnnotationView::sample(int i) const
+{
+	return _samples[i];
+}
+
+inline int AnnotationView::type(int i) const
+{
+	return _types[i];
+}
+
+inline int AnnotationView::aux(int i) const
+{
+	return _aux[i];
+}
+
+inline int AnnotationView::getSize() const
+{
+	return _size;
+}
+
+inline bool AnnotationView::empty() const
+{
+	return _size == 0;
+}
+
+inline const int* AnnotationView::getSamples() const
+{
+	return _samples;
+}
+
+inline const int* AnnotationView::getTypes() const
+{
+	return _types;
+}
+
+inline const int* AnnotationView::getAux() const
+{
+	return _aux;
+}
+
+inline int AnnotationTable::getSize() const
+{
+	return int(_samples.size());
+}
+
+inline bool AnnotationTable::empty() const
+{
+	return _samples.empty();
+}
+
+inline int* AnnotationTable::getSamples()
+{
+	return _samples.data();
+}
+
+inline int* AnnotationTable::getTypes()
+{
+	return _types.data();
+}
+
+inline int* AnnotationTable::getAux()
+{
+	return _aux.data();
+}
+
+inline const int* AnnotationTable::getSamples() const
+{
+	return _samples.data();
+}
+
+inline const int* AnnotationTable::getTypes() const
+{
+	return _types.data();
+}
+
+inline const int* AnnotationTable::getAux() const
+{
+	return _aux.data();
+}
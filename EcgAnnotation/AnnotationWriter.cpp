@@ -13,14 +13,15 @@ AnnotationWriter::~AnnotationWriter()
 }
 
 
-bool AnnotationWriter::SaveQTseq(const char *name, int **ann, int annsize, double sr, int length)
+bool AnnotationWriter::SaveQTseq(const char *name, AnnotationView ann, double sr, int length)
 {
+	const int annsize = ann.getSize();
 	std::vector<double> QT;
 	int q = 0;
 
 
 	for (int i = 0; i < annsize; i++) {
-		switch (ann[i][1]) {
+		switch (ann.type(i)) {
 		case 14:            //noise
 		case 15:            //q
 		case 16:            //artifact
@@ -57,20 +58,20 @@ bool AnnotationWriter::SaveQTseq(const char *name, int **ann, int annsize, doubl
 			break;
 		}
 
-		if (ann[i][1] == 45)
+		if (ann.type(i) == 45)
 		{
 			//45 - t)
-			const int t = ann[i][0];
+			const int t = ann.sample(i);
 			if (q < t)
 				QT.push_back(double(t - q) / sr);
 		}
 		else {
-			/*if(i+1<annsize && (ann[i+1][1]==47 || ann[i+1][1]==48))  //r only
-			 q = ann[i+1][0];
-			else if(i+2<annsize && (ann[i+2][1]==47 || ann[i+2][1]==48))  //q,r
-			 q = ann[i+2][0];
+			/*if(i+1<annsize && (ann.type(i+1)==47 || ann.type(i+1)==48))  //r only
+			 q = ann.sample(i+1);
+			else if(i+2<annsize && (ann.type(i+2)==47 || ann.type(i+2)==48))  //q,r
+			 q = ann.sample(i+2);
 			else*/
-			q = ann[i][0];
+			q = ann.sample(i);
 		}
 	}
 
@@ -92,14 +93,15 @@ bool AnnotationWriter::SaveQTseq(const char *name, int **ann, int annsize, doubl
 	return false;
 }
 
-bool AnnotationWriter::SavePQseq(const char *name, int **ann, int annsize, double sr, int length)
+bool AnnotationWriter::SavePQseq(const char *name, AnnotationView ann, double sr, int length)
 {
+	const int annsize = ann.getSize();
 	std::vector <double> PQ;
 	int p = length;
 
 
 	for (int i = 0; i < annsize; i++) {
-		switch (ann[i][1]) {
+		switch (ann.type(i)) {
 		case 14:            //noise
 		case 15:            //q
 		case 16:            //artifact
@@ -136,10 +138,10 @@ bool AnnotationWriter::SavePQseq(const char *name, int **ann, int annsize, doubl
 			break;
 		}
 
-		if (ann[i][1] == 42)   //42 - (p
-			p = ann[i][0];
+		if (ann.type(i) == 42)   //42 - (p
+			p = ann.sample(i);
 		else {
-			const int q = ann[i][0];
+			const int q = ann.sample(i);
 			if (p < q) {
 				PQ.push_back(double(q - p) / sr);
 				p = length;
@@ -165,18 +167,19 @@ bool AnnotationWriter::SavePQseq(const char *name, int **ann, int annsize, doubl
 	return false;
 }
 
-bool AnnotationWriter::SavePPseq(const char *name, int **ann, int annsize, double sr, int length)
+bool AnnotationWriter::SavePPseq(const char *name, AnnotationView ann, double sr, int length)
 {
+	const int annsize = ann.getSize();
 	std::vector <double> PP;
 	int p1 = 0;
 
 	for (int i = 0; i < annsize; i++) {
-		if (ann[i][1] == 42)      //42 - (p
-			p1 = ann[i][0];
-		else if (ann[i][1] == 43)
+		if (ann.type(i) == 42)      //42 - (p
+			p1 = ann.sample(i);
+		else if (ann.type(i) == 43)
 		{
 			//43 - p)
-			const int p2 = ann[i][0];
+			const int p2 = ann.sample(i);
 			PP.push_back(double(p2 - p1) / sr);
 		}
 	}
@@ -199,8 +202,9 @@ bool AnnotationWriter::SavePPseq(const char *name, int **ann, int annsize, doubl
 	return false;
 }
 
-bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, int **ann, int nums, double sr, int length) const
+bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, AnnotationView ann, double sr, int length) const
 {
+	const int nums = ann.getSize();
 	vector <double> RR;
 	int add = -1;
 	double r1 = 0, r2 = 0;
@@ -209,8 +213,8 @@ bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, int **ann, int num
 	bool rrs = true;
 	int rNum = 0, sNum = 0;
 	for (int i = 0; i < nums; i++) {
-		if (ann[i][1] == 47 || ann[i][1] == 48) rNum++;
-		else if (ann[i][1] == 49 || ann[i][1] == 50) sNum++;
+		if (ann.type(i) == 47 || ann.type(i) == 48) rNum++;
+		else if (ann.type(i) == 49 || ann.type(i) == 50) sNum++;
 	}
 	if (int(1.1f*float(rNum)) < sNum) {
 		rrs = false;  //R peaks less than S ones
@@ -223,7 +227,7 @@ bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, int **ann, int num
 
 
 	for (int i = 0; i < nums; i++) {
-		switch (ann[i][1]) {
+		switch (ann.type(i)) {
 		case 0:    //non beats
 		case 15:   //q
 		case 17:   //Q
@@ -267,47 +271,47 @@ bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, int **ann, int num
 		if (add != -1) {
 			//annotation on RRs peaks
 			if (rrs) {
-				if (i + 1 < nums && (ann[i + 1][1] == 47 || ann[i + 1][1] == 48))  //r only
-					r2 = ann[i + 1][0];
-				else if (i + 2 < nums && (ann[i + 2][1] == 47 || ann[i + 2][1] == 48))  //q,r
-					r2 = ann[i + 2][0];
-				else //(ann[i][1]==N,ECT,...)  //no detected R only S
-					r2 = ann[i][0];
-
-				if (add + 1 < nums && (ann[add + 1][1] == 47 || ann[add + 1][1] == 48))
-					r1 = ann[add + 1][0];
-				else if (add + 2 < nums && (ann[add + 2][1] == 47 || ann[add + 2][1] == 48))
-					r1 = ann[add + 2][0];
-				else //(ann[add][1]==N,ECT,...) //no detected R only S
-					r1 = ann[add][0];
+				if (i + 1 < nums && (ann.type(i + 1) == 47 || ann.type(i + 1) == 48))  //r only
+					r2 = ann.sample(i + 1);
+				else if (i + 2 < nums && (ann.type(i + 2) == 47 || ann.type(i + 2) == 48))  //q,r
+					r2 = ann.sample(i + 2);
+				else //(ann.type(i)==N,ECT,...)  //no detected R only S
+					r2 = ann.sample(i);
+
+				if (add + 1 < nums && (ann.type(add + 1) == 47 || ann.type(add + 1) == 48))
+					r1 = ann.sample(add + 1);
+				else if (add + 2 < nums && (ann.type(add + 2) == 47 || ann.type(add + 2) == 48))
+					r1 = ann.sample(add + 2);
+				else //(ann.type(add)==N,ECT,...) //no detected R only S
+					r1 = ann.sample(add);
 			}
 			//annotation on S peaks
 			else {
-				if (i + 1 < nums && (ann[i + 1][1] == 40))  //N)
-					r2 = ann[i][0];
-				else if (i + 1 < nums && (ann[i + 1][1] == 49 || ann[i + 1][1] == 50))  //Sr
-					r2 = ann[i + 1][0];
-				else if (i + 2 < nums && (ann[i + 2][1] == 49 || ann[i + 2][1] == 50))  //rS
-					r2 = ann[i + 2][0];
-				else if (i + 3 < nums && (ann[i + 3][1] == 49 || ann[i + 3][1] == 50))  //errQ rS
-					r2 = ann[i + 3][0];
-				else if (i + 1 < nums && (ann[i + 1][1] == 47 || ann[i + 1][1] == 48))  //no S
-					r2 = ann[i + 1][0];
-				else if (i + 2 < nums && (ann[i + 2][1] == 47 || ann[i + 2][1] == 48))  //no S
-					r2 = ann[i + 2][0];
-
-				if (add + 1 < nums && (ann[add + 1][1] == 40))  //N)
-					r1 = ann[add][0];
-				else if (add + 1 < nums && (ann[add + 1][1] == 49 || ann[add + 1][1] == 50))
-					r1 = ann[add + 1][0];
-				else if (add + 2 < nums && (ann[add + 2][1] == 49 || ann[add + 2][1] == 50))
-					r1 = ann[add + 2][0];
-				else if (add + 3 < nums && (ann[add + 3][1] == 49 || ann[add + 3][1] == 50))
-					r1 = ann[add + 3][0];
-				else if (add + 1 < nums && (ann[add + 1][1] == 47 || ann[add + 1][1] == 48))  //no S
-					r1 = ann[add + 1][0];
-				else if (add + 2 < nums && (ann[add + 2][1] == 47 || ann[add + 2][1] == 48))  //no S
-					r1 = ann[add + 2][0];
+				if (i + 1 < nums && (ann.type(i + 1) == 40))  //N)
+					r2 = ann.sample(i);
+				else if (i + 1 < nums && (ann.type(i + 1) == 49 || ann.type(i + 1) == 50))  //Sr
+					r2 = ann.sample(i + 1);
+				else if (i + 2 < nums && (ann.type(i + 2) == 49 || ann.type(i + 2) == 50))  //rS
+					r2 = ann.sample(i + 2);
+				else if (i + 3 < nums && (ann.type(i + 3) == 49 || ann.type(i + 3) == 50))  //errQ rS
+					r2 = ann.sample(i + 3);
+				else if (i + 1 < nums && (ann.type(i + 1) == 47 || ann.type(i + 1) == 48))  //no S
+					r2 = ann.sample(i + 1);
+				else if (i + 2 < nums && (ann.type(i + 2) == 47 || ann.type(i + 2) == 48))  //no S
+					r2 = ann.sample(i + 2);
+
+				if (add + 1 < nums && (ann.type(add + 1) == 40))  //N)
+					r1 = ann.sample(add);
+				else if (add + 1 < nums && (ann.type(add + 1) == 49 || ann.type(add + 1) == 50))
+					r1 = ann.sample(add + 1);
+				else if (add + 2 < nums && (ann.type(add + 2) == 49 || ann.type(add + 2) == 50))
+					r1 = ann.sample(add + 2);
+				else if (add + 3 < nums && (ann.type(add + 3) == 49 || ann.type(add + 3) == 50))
+					r1 = ann.sample(add + 3);
+				else if (add + 1 < nums && (ann.type(add + 1) == 47 || ann.type(add + 1) == 48))  //no S
+					r1 = ann.sample(add + 1);
+				else if (add + 2 < nums && (ann.type(add + 2) == 47 || ann.type(add + 2) == 48))  //no S
+					r1 = ann.sample(add + 2);
 			}
 
 			double rr = 60.0 / ((r2 - r1) / sr);
@@ -333,8 +337,9 @@ bool AnnotationWriter::SaveRRseq(char *name, ANN_HEADER _hdr, int **ann, int num
 	return false;
 }
 
-bool AnnotationWriter::SaveRRnseq(char *name, ANN_HEADER& _hdr, int **ann, int nums, double sr, int length) const
+bool AnnotationWriter::SaveRRnseq(char *name, ANN_HEADER& _hdr, AnnotationView ann, double sr, int length) const
 {
+	const int nums = ann.getSize();
 	vector <double> RR;
 	int add = -1;
 	double r1 = 0, r2 = 0;
@@ -343,8 +348,8 @@ bool AnnotationWriter::SaveRRnseq(char *name, ANN_HEADER& _hdr, int **ann, int n
 	bool rrs = true;
 	int rNum = 0, sNum = 0;
 	for (int i = 0; i < nums; i++) {
-		if (ann[i][1] == 47 || ann[i][1] == 48) rNum++;
-		else if (ann[i][1] == 49 || ann[i][1] == 50) sNum++;
+		if (ann.type(i) == 47 || ann.type(i) == 48) rNum++;
+		else if (ann.type(i) == 49 || ann.type(i) == 50) sNum++;
 	}
 	if (int(1.1f*float(rNum)) < sNum) {
 		rrs = false;  //R peaks less than S ones
@@ -356,7 +361,7 @@ bool AnnotationWriter::SaveRRnseq(char *name, ANN_HEADER& _hdr, int **ann, int n
 
 
 	for (int i = 0; i < nums; i++) {
-		switch (ann[i][1]) {
+		switch (ann.type(i)) {
 		case 1:             //N
 			if (add == -1) {
 				add = i;
@@ -390,47 +395,47 @@ bool AnnotationWriter::SaveRRnseq(char *name, ANN_HEADER& _hdr, int **ann, int n
 
 		//annotation on RRs peaks
 		if (rrs) {
-			if (i + 1 < nums && (ann[i + 1][1] == 47 || ann[i + 1][1] == 48))  //r only
-				r2 = ann[i + 1][0];
-			else if (i + 2 < nums && (ann[i + 2][1] == 47 || ann[i + 2][1] == 48))  //q,r
-				r2 = ann[i + 2][0];
-			else //(ann[i][1]==N,ECT,...)  //no detected R only S
-				r2 = ann[i][0];
-
-			if (add + 1 < nums && (ann[add + 1][1] == 47 || ann[add + 1][1] == 48))
-				r1 = ann[add + 1][0];
-			else if (add + 2 < nums && (ann[add + 2][1] == 47 || ann[add + 2][1] == 48))
-				r1 = ann[add + 2][0];
-			else //(ann[add][1]==N,ECT,...) //no detected R only S
-				r1 = ann[add][0];
+			if (i + 1 < nums && (ann.type(i + 1) == 47 || ann.type(i + 1) == 48))  //r only
+				r2 = ann.sample(i + 1);
+			else if (i + 2 < nums && (ann.type(i + 2) == 47 || ann.type(i + 2) == 48))  //q,r
+				r2 = ann.sample(i + 2);
+			else //(ann.type(i)==N,ECT,...)  //no detected R only S
+				r2 = ann.sample(i);
+
+			if (add + 1 < nums && (ann.type(add + 1) == 47 || ann.type(add + 1) == 48))
+				r1 = ann.sample(add + 1);
+			else if (add + 2 < nums && (ann.type(add + 2) == 47 || ann.type(add + 2) == 48))
+				r1 = ann.sample(add + 2);
+			else //(ann.type(add)==N,ECT,...) //no detected R only S
+				r1 = ann.sample(add);
 		}
 		//annotation on S peaks
 		else {
-			if (i + 1 < nums && (ann[i + 1][1] == 40))  //N)
-				r2 = ann[i][0];
-			else if (i + 1 < nums && (ann[i + 1][1] == 49 || ann[i + 1][1] == 50))  //Sr
-				r2 = ann[i + 1][0];
-			else if (i + 2 < nums && (ann[i + 2][1] == 49 || ann[i + 2][1] == 50))  //rS
-				r2 = ann[i + 2][0];
-			else if (i + 3 < nums && (ann[i + 3][1] == 49 || ann[i + 3][1] == 50))  //errQ rS
-				r2 = ann[i + 3][0];
-			else if (i + 1 < nums && (ann[i + 1][1] == 47 || ann[i + 1][1] == 48))  //no S
-				r2 = ann[i + 1][0];
-			else if (i + 2 < nums && (ann[i + 2][1] == 47 || ann[i + 2][1] == 48))  //no S
-				r2 = ann[i + 2][0];
-
-			if (add + 1 < nums && (ann[add + 1][1] == 40))  //N)
-				r1 = ann[add][0];
-			else if (add + 1 < nums && (ann[add + 1][1] == 49 || ann[add + 1][1] == 50))
-				r1 = ann[add + 1][0];
-			else if (add + 2 < nums && (ann[add + 2][1] == 49 || ann[add + 2][1] == 50))
-				r1 = ann[add + 2][0];
-			else if (add + 3 < nums && (ann[add + 3][1] == 49 || ann[add + 3][1] == 50))
-				r1 = ann[add + 3][0];
-			else if (add + 1 < nums && (ann[add + 1][1] == 47 || ann[add + 1][1] == 48))  //no S
-				r1 = ann[add + 1][0];
-			else if (add + 2 < nums && (ann[add + 2][1] == 47 || ann[add + 2][1] == 48))  //no S
-				r1 = ann[add + 2][0];
+			if (i + 1 < nums && (ann.type(i + 1) == 40))  //N)
+				r2 = ann.sample(i);
+			else if (i + 1 < nums && (ann.type(i + 1) == 49 || ann.type(i + 1) == 50))  //Sr
+				r2 = ann.sample(i + 1);
+			else if (i + 2 < nums && (ann.type(i + 2) == 49 || ann.type(i + 2) == 50))  //rS
+				r2 = ann.sample(i + 2);
+			else if (i + 3 < nums && (ann.type(i + 3) == 49 || ann.type(i + 3) == 50))  //errQ rS
+				r2 = ann.sample(i + 3);
+			else if (i + 1 < nums && (ann.type(i + 1) == 47 || ann.type(i + 1) == 48))  //no S
+				r2 = ann.sample(i + 1);
+			else if (i + 2 < nums && (ann.type(i + 2) == 47 || ann.type(i + 2) == 48))  //no S
+				r2 = ann.sample(i + 2);
+
+			if (add + 1 < nums && (ann.type(add + 1) == 40))  //N)
+				r1 = ann.sample(add);
+			else if (add + 1 < nums && (ann.type(add + 1) == 49 || ann.type(add + 1) == 50))
+				r1 = ann.sample(add + 1);
+			else if (add + 2 < nums && (ann.type(add + 2) == 49 || ann.type(add + 2) == 50))
+				r1 = ann.sample(add + 2);
+			else if (add + 3 < nums && (ann.type(add + 3) == 49 || ann.type(add + 3) == 50))
+				r1 = ann.sample(add + 3);
+			else if (add + 1 < nums && (ann.type(add + 1) == 47 || ann.type(add + 1) == 48))  //no S
+				r1 = ann.sample(add + 1);
+			else if (add + 2 < nums && (ann.type(add + 2) == 47 || ann.type(add + 2) == 48))  //no S
+				r1 = ann.sample(add + 2);
 		}
 
 		double rr = 60.0 / ((r2 - r1) / sr);
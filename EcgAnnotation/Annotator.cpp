@@ -1,29 +1,33 @@
 #include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "Annotator.h"
 #include "helper.h"
 #include "ContinuousWaveletTransform.h"
 #include "FastWaveletTransform.h"
 #include "Denoise.h"
+#include "QrsDetector.h"
 #include "signal.h"
 
 std::string Annotator::_filterPath = "filter";
 
 int Annotator::getQRSNumber() const
 {
-	return _qrsNum;
+	return _qrsAnn.getSize() / 2;
 }
 
 int Annotator::getAnnotationSize() const
 {
-	return _annNum;
+	return _ann.getSize();
 }
 
-int** Annotator::getAnnotation() const
+AnnotationView Annotator::getAnnotation() const
 {
 	return _ann;
 }
 
-int** Annotator::getQRSAnnotation() const
+AnnotationView Annotator::getQRSAnnotation() const
 {
 	return _qrsAnn;
 }
@@ -38,14 +42,6 @@ PANN_HEADER Annotator::getAnnotationHeader()
 	return &_hdr;
 }
 
-bool Annotator::_isNoise(const double *data, const int window)
-{
-	for (int i = 0; i < window; i++)
-		if (abs(data[i]) > FLOAT_EQ_ERR) return true;
-
-	return false;
-}
-
 void Annotator::_find_RS(const double *data, const int size, int &R, int &S, const double err) //find RS or QR
 {
 	double min, max;
@@ -155,8 +151,7 @@ inline int Annotator::_find_s(const double *data, int size, double err) const  /
 	return -1;
 }
 
-Annotator::Annotator(PANN_HEADER p) : _ann(nullptr), _annNum(0), _qrsAnn(nullptr),
-_qrsNum(0), _auxNum(0), _aux(nullptr)
+Annotator::Annotator(PANN_HEADER p) : _auxNum(0), _aux(nullptr)
 {
 	if (p) {
 		memcpy(&_hdr, p, sizeof(ANN_HEADER));
@@ -181,16 +176,6 @@ _qrsNum(0), _auxNum(0), _aux(nullptr)
 
 Annotator::~Annotator()
 {
-	if (_ann) {
-		for (int i = 0; i < _annNum; i++)
-			delete[] _ann[i];
-		delete[] _ann;
-	}
-	if (_qrsAnn) {
-		for (int i = 0; i < _qrsNum; i++)
-			delete[] _qrsAnn[i];
-		delete[] _qrsAnn;
-	}
 	if (_aux) {
 		for (int i = 0; i < _auxNum; i++)
 			delete[] _aux[i];
@@ -203,125 +188,78 @@ Annotator::~Annotator()
 // spectrum in cwt class
 // create qrsANN array   with qrsNum records  num of heart beats = qrsNum/2
 //
-int** Annotator::getQRS(const double *data, int size, double sampleRate)
+AnnotationTable* Annotator::getQRS(const double *data, int size, double sampleRate)
 {
 
-	double *pdata = new double[size_t(size) * sizeof(double)];
-	for (int i = 0; i < size; i++)
-		pdata[i] = data[i];
-
-	if (_filter30Hz(pdata, size, sampleRate) == false) { //pdata filed with filterd signal
-		delete[] pdata;
+	std::vector<double> pdata(data, data + size);
+	if (_filter30Hz(pdata.data(), size, sampleRate) == false) //pdata filed with filterd signal
 		return nullptr;
-	}
 
 
-	double eCycle = (60.0 / double(_hdr.maxbpm)) - _hdr.maxQRS;  //secs
-	if (int(eCycle*sampleRate) <= 0) {
-		eCycle = 0.1;
-		_hdr.maxbpm = int(60.0 / (_hdr.maxQRS + eCycle));
-	}
-	//////////////////////////////////////////////////////////////////////////////
-
-	int lqNum = 0;
 	std::vector <int> qrs;    //clean QRS detected
-	int add = 0;
-
-	while (abs(pdata[add]) > FLOAT_EQ_ERR) add += int(0.1 * sampleRate);                  //skip QRS in begining
-	while (abs(pdata[add]) < FLOAT_EQ_ERR) add++;                            //get  1st QRS
+	QrsDetector detector(&_hdr);
+	detector.init(sampleRate, [&qrs](int onset, int offset) {
+		qrs.push_back(onset);
+		qrs.push_back(offset);
+	}, true);
+	detector.push(pdata.data(), size);
+	detector.finish();
+	pdata = std::vector<double>();                //filtered copy freed before the tables grow
 
-	qrs.push_back(add - 1);
-	/////////////////////////////////////////////////////////////////////////////
-	for (int m = add; m < size; m++) {                  //MAX 200bpm  [0,3 sec  min cario size]
-		m += int(_hdr.maxQRS * sampleRate);                     //smpl + 0,20sec    [0,20 max QRS length]
+	_hdr.maxbpm = detector.getAnnotationHeader()->maxbpm;
+	_ma.assign(detector.getNoise().begin(), detector.getNoise().end());      //MA noise of this record
 
 
-		if (m >= size) m = size - 1;
-		add = 0;
-
-		//noise checking///////////////////////////////////////
-		if (m + int(eCycle*sampleRate) >= size) { //near end of signal
-			qrs.pop_back();
-			break;
-		}
-		if (_isNoise(&pdata[m], int(eCycle*sampleRate))) {  //smp(0.10sec)+0,20sec in noise
-			if (lqNum != int(qrs.size()) - 1)
-				_ma.push_back(qrs[qrs.size() - 1]);     //push MA noise location
-
-			qrs.pop_back();
-			lqNum = int(qrs.size());
-
-			//Find for next possible QRS start
-			while (_isNoise(&pdata[m], int(eCycle*sampleRate))) {
-				m += int(eCycle * sampleRate);
-				if (m >= size - int(eCycle*sampleRate)) break;   //end of signal
-			}
-
-			if (m >= size - int(eCycle*sampleRate)) break;
-			while (pdata[m] > FLOAT_EQ_ERR) {
-				m++;
-				if (m >= size) break;
-			}
-			if (m >= size) break;
-			qrs.push_back(m - 1);
-			continue;
-		}
-		////////////////////////////////////////////////////////
-
-
-		while (pdata[m - add] == 0.0) add++;               //Find back for QRS end
-
-
-		if ((m - add + 1) - qrs[qrs.size() - 1] > _hdr.minQRS*sampleRate)  //QRS size > 0.04 sec
-			qrs.push_back(m - add + 2); //QRS end
-		else
-			qrs.pop_back();
-
-
-		m += int(eCycle * sampleRate);                                //smpl + [0,20+0,10]sec    200bpm MAX
-		if (size - m < int(sampleRate / 2)) break;
-
-
-
-		while (abs(pdata[m]) < FLOAT_EQ_ERR && (size - m) >= int(sampleRate / 2))   //Find nearest QRS
-			m++;
-
-		if (size - m < int(sampleRate / 2)) break;  //end of data
-
-		qrs.push_back(m - 1);  //QRS begin
-	}
-	/////////////////////////////////////////////////////////////////////////////
-	delete[] pdata;
 
+	const int qrsNum = int(qrs.size()) / 2;
 
-
-	_qrsNum = qrs.size() / 2;
-
-	if (_qrsNum > 0)                              //         46: ?
-	{                                           //          1: N    -1: nodata in **AUX
-		_qrsAnn = new int*[size_t(2 * _qrsNum)];                    // [samps] [type] [?aux data]
-		for (int i = 0; i < 2 * _qrsNum; i++)
-			_qrsAnn[i] = new int[3];
-
-		for (int i = 0; i < 2 * _qrsNum; i++) {
-			_qrsAnn[i][0] = qrs[i];                                     //samp
-
+	_qrsAnn.clear();
+	if (qrsNum > 0)                              //         46: ?
+	{                                           //          1: N    -1: nodata in aux
+		_qrsAnn.reserve(2 * qrsNum);                                // [samps] [type] [?aux data]
+		for (int i = 0; i < 2 * qrsNum; i++) {
 			if (i % 2 == 0)
-				_qrsAnn[i][1] = 1;                                        //type N
+				_qrsAnn.add(qrs[i], 1);                                   //type N
 			else {
-				_qrsAnn[i][1] = 40;                                      //type QRS)
+				_qrsAnn.add(qrs[i], 40);                                  //type QRS)
 				//if( (qrsANN[i][0]-qrsANN[i-1][0]) >= int(sr*0.12) || (qrsANN[i][0]-qrsANN[i-1][0]) <= int(sr*0.03) )
 				// qrsANN[i-1][1] = 46;                                  //N or ? beat  (0.03?-0.12secs)
 			}
-
-			_qrsAnn[i][2] = -1;                                         //no aux data
 		}
 
-		return _qrsAnn;
+		return &_qrsAnn;
 	}
 	return nullptr;
 }
 
+//least common multiple over the scales j of window_j * 2^j samples, window_j the _filter30Hz
+//threshold window in coefficients of scale j, and of the 2^J samples the baseline removal of getPTU
+//(Denoise::LFDenoise) decimates by
+int Annotator::getFilterAlignment(double sampleRate)
+{
+	std::vector<int> periods;
+	const int J = int(ceil(log2(sampleRate / 23.0)) - 2);
+	for (int j = 1; j <= J; j++)
+		periods.push_back(int((2.0 * sampleRate) / pow(2.0, double(j))) << j);
+	const int baseline = int(ceil(log2(sampleRate / 0.8)) - 1);
+	if (baseline > 0)
+		periods.push_back(1 << baseline);
+
+	int alignment = 1;
+	for (size_t i = 0; i < periods.size(); i++) {
+		if (periods[i] <= 0)
+			continue;
+		int a = alignment, b = periods[i];
+		while (b) {
+			const int r = a % b;
+			a = b;
+			b = r;
+		}
+		alignment = alignment / a * periods[i];
+	}
+	return alignment;
+}
+
 bool Annotator::_filter30Hz(double *data, int size, double sampleRate) const
 {
 	ContinuousWaveletTransform cwt;
@@ -391,14 +329,18 @@ bool Annotator::_filter30Hz(double *data, int size, double sampleRate) const
 
 ////////////////////////////////////////////////////////////////////////////////
 // Find ectopic beats in HRV data
-void Annotator::getEctopia(int **annotations, const int qrsNum, const double sampleRate) const
+void Annotator::getEctopia(AnnotationTable &annotations, const double sampleRate) const
 {
+	const int qrsNum = annotations.getSize() / 2;
+	const int *samples = annotations.getSamples();
+	int *types = annotations.getTypes();
+
 	if (qrsNum < 3)
 		return;
 
 	std::vector<double> RRs;
 	for (int n = 0; n < qrsNum - 1; n++)
-		RRs.push_back(double(annotations[n * 2 + 2][0] - annotations[n * 2][0]) / sampleRate); //qrsNum-1 rr's
+		RRs.push_back(double(samples[n * 2 + 2] - samples[n * 2]) / sampleRate); //qrsNum-1 rr's
 	RRs.push_back(RRs[RRs.size() - 1]);
 
 	//  [RR1  RR2  RR3]   RR2 beat classification
@@ -428,15 +370,15 @@ void Annotator::getEctopia(int **annotations, const int qrsNum, const double sam
 			continue;
 
 		if (1.15*rr2 < rr1 && 1.15*rr2 < rr3) {
-			annotations[n * 2 + 4][1] = 46;
+			types[n * 2 + 4] = 46;
 			continue;
 		}
 		if (fabs(rr1 - rr2) < 0.3 && rr1 < 0.8 && rr2 < 0.8 && rr3 > 2.4*(rr1 + rr2)) {
-			annotations[n * 2 + 4][1] = 46;
+			types[n * 2 + 4] = 46;
 			continue;
 		}
 		if (fabs(rr1 - rr2) < 0.3 && rr1 < 0.8 && rr2 < 0.8 && rr3 > 2.4*(rr2 + rr3)) {
-			annotations[n * 2 + 4][1] = 46;
+			types[n * 2 + 4] = 46;
 			continue;
 		}
 	}
@@ -446,260 +388,257 @@ void Annotator::getEctopia(int **annotations, const int qrsNum, const double sam
 ///////////////////////////////////////////////////////////////////////////////
 //out united annotation with QRS PT////////////////////////////////////////////
 // **ann [PQ,JP] pairs
-int** Annotator::getPTU(const double *data, const int length, const double sampleRate, int **annotations, const int qrsNum)
+//P and T waves of the RR interval n: [T1 T T2] to tWave, [P1 P P2] to pWave, zeros if not found.
+//cwt is the workspace of the calling thread
+void Annotator::_getPT(const double *data, const double sampleRate, AnnotationView annotations, const int n,
+                       ContinuousWaveletTransform &cwt, int *tWave, int *pWave) const
 {
-	int size, annPos;
 	int T1 = -1;
 	int T = -1;
 	int T2 = -1;
-	int tWaves = 0;
 	int P1 = -1;
 	int P = -1;
 	int P2 = -1;
-	int pWaves = 0;
-	ContinuousWaveletTransform cwt;
-	std::vector <int> pWave;
-	std::vector <int> tWave;                             //Twave [ ( , T , ) ]
 	double min, max;                           //min,max for gaussian1 wave, center is zero crossing
 
 	bool sign;
 
 	const int add = 0;//int(sr*0.04);  //prevent imprecise QRS end detection
 
-	int maNum = 0;
-	for (int n = 0; n < qrsNum - 1; n++) {
-		annPos = annotations[n * 2 + 1][0];                //i
-		size = annotations[n * 2 + 2][0] - annotations[n * 2 + 1][0];  //i   size of  (QRS) <----> (QRS)
-
-		bool maNs = false;
-		for (int i = maNum; i < int(_ma.size()); i++) {
-			if (_ma[i] > annotations[n * 2 + 1][0] && _ma[i] < annotations[n * 2 + 2][0]) {
-				pWave.push_back(0);
-				pWave.push_back(0);
-				pWave.push_back(0);
-				tWave.push_back(0);
-				tWave.push_back(0);
-				tWave.push_back(0);
-				maNum++;
-				maNs = true;
-				break;
-			}
-		}
-		if (maNs) continue;
+	for (int i = 0; i < 3; i++) {
+		tWave[i] = 0;
+		pWave[i] = 0;
+	}
 
+	const int annPos = annotations.sample(n * 2 + 1);                //i
+	int size = annotations.sample(n * 2 + 2) - annotations.sample(n * 2 + 1);  //i   size of  (QRS) <----> (QRS)
 
-		const double rr = double(annotations[n * 2 + 2][0] - annotations[n * 2][0]) / sampleRate;
-		if (60.0 / rr < _hdr.minbpm || 60.0 / rr > _hdr.maxbpm - 20) { //check if normal RR interval (40bpm - 190bpm)
-			pWave.push_back(0);
-			pWave.push_back(0);
-			pWave.push_back(0);
-			tWave.push_back(0);
-			tWave.push_back(0);
-			tWave.push_back(0);
-			continue;
-		}
+	const double rr = double(annotations.sample(n * 2 + 2) - annotations.sample(n * 2)) / sampleRate;
+	if (60.0 / rr < _hdr.minbpm || 60.0 / rr > _hdr.maxbpm - 20) //check if normal RR interval (40bpm - 190bpm)
+		return;
 
 
-		///////////////search for TWAVE///////////////////////////////////////////////////////////
+	///////////////search for TWAVE///////////////////////////////////////////////////////////
 
-		if (sampleRate*_hdr.maxQT - (annotations[n * 2 + 1][0] - annotations[n * 2 + 0][0]) > size - add)
-			size = size - add;
-		else
-			size = int(sampleRate * _hdr.maxQT - (annotations[n * 2 + 1][0] - annotations[n * 2 + 0][0]) - add);
+	if (sampleRate*_hdr.maxQT - (annotations.sample(n * 2 + 1) - annotations.sample(n * 2 + 0)) > size - add)
+		size = size - add;
+	else
+		size = int(sampleRate * _hdr.maxQT - (annotations.sample(n * 2 + 1) - annotations.sample(n * 2 + 0)) - add);
 
 
-		//double avg = Mean(data+annPos+add,size);         //avrg extension on boundaries
-		//double lvl,rvl;
-		//lvl = data[annPos+add];
-		//rvl = data[annPos+add+size-1];
-		if (_hdr.biTwave == BIPHASE)
-			cwt.init(size, ContinuousWaveletTransform::GAUS, 0, sampleRate);                 //5-Gauss wlet
-		else
-			cwt.init(size, ContinuousWaveletTransform::GAUS1, 0, sampleRate);                //6-Gauss1 wlet
+	//double avg = Mean(data+annPos+add,size);         //avrg extension on boundaries
+	//double lvl,rvl;
+	//lvl = data[annPos+add];
+	//rvl = data[annPos+add+size-1];
+	if (_hdr.biTwave == BIPHASE)
+		cwt.init(size, ContinuousWaveletTransform::GAUS, 0, sampleRate);                 //5-Gauss wlet
+	else
+		cwt.init(size, ContinuousWaveletTransform::GAUS1, 0, sampleRate);                //6-Gauss1 wlet
 
-		double* pSpec = cwt.Transform(data + annPos + add, _hdr.tFreq);//,false,lvl,rvl);   //3Hz transform  pspec = size-2*add
+	double* pSpec = cwt.Transform(data + annPos + add, _hdr.tFreq);//,false,lvl,rvl);   //3Hz transform  pspec = size-2*add
 
-		//cwt.ToTxt(L"debugS.txt",data+annPos+add,size);    //T wave
-		//cwt.ToTxt(L"debugC.txt",pspec,size);               //T wave spectrum
+	//cwt.ToTxt(L"debugS.txt",data+annPos+add,size);    //T wave
+	//cwt.ToTxt(L"debugC.txt",pspec,size);               //T wave spectrum
 
-		MinMax(pSpec, size, min, max);
-		for (int i = 0; i < size; i++) {
-			if (abs(pSpec[i] - min) < FLOAT_EQ_ERR) T1 = i + annPos + add;
-			if (abs(pSpec[i] - max) < FLOAT_EQ_ERR) T2 = i + annPos + add;
-		}
-		if (T1 > T2)std::swap(T1, T2);
-
-		//additional constraints on [T1 T T2] duration, symmetry, QT interval
-		bool t_wave = false;
-		if ((pSpec[T1 - annPos - add] < 0 && pSpec[T2 - annPos - add] > 0) || (pSpec[T1 - annPos - add] > 0 && pSpec[T2 - annPos - add] < 0))
-			t_wave = true;
-		if (t_wave) {
-			if (double(T2 - T1) >= 0.09*sampleRate) { // && (double)(T2-T1)<=0.24*sr)   //check for T wave duration
-				if (double(T2 - annotations[n * 2 + 0][0]) >= _hdr.minQT*sampleRate && double(T2 - annotations[n * 2 + 0][0]) <= _hdr.maxQT*sampleRate)
-					t_wave = true;
-				else
-					t_wave = false;
-			}
+	MinMax(pSpec, size, min, max);
+	for (int i = 0; i < size; i++) {
+		if (abs(pSpec[i] - min) < FLOAT_EQ_ERR) T1 = i + annPos + add;
+		if (abs(pSpec[i] - max) < FLOAT_EQ_ERR) T2 = i + annPos + add;
+	}
+	if (T1 > T2)std::swap(T1, T2);
+
+	//additional constraints on [T1 T T2] duration, symmetry, QT interval
+	bool t_wave = false;
+	if ((pSpec[T1 - annPos - add] < 0 && pSpec[T2 - annPos - add] > 0) || (pSpec[T1 - annPos - add] > 0 && pSpec[T2 - annPos - add] < 0))
+		t_wave = true;
+	if (t_wave) {
+		if (double(T2 - T1) >= 0.09*sampleRate) { // && (double)(T2-T1)<=0.24*sr)   //check for T wave duration
+			if (double(T2 - annotations.sample(n * 2 + 0)) >= _hdr.minQT*sampleRate && double(T2 - annotations.sample(n * 2 + 0)) <= _hdr.maxQT*sampleRate)
+				t_wave = true;
 			else
 				t_wave = false;
 		}
+		else
+			t_wave = false;
+	}
 
-		if (t_wave) {
-			if (pSpec[T1 - annPos - add] > 0) sign = true;
-			else sign = false;
+	if (t_wave) {
+		if (pSpec[T1 - annPos - add] > 0) sign = true;
+		else sign = false;
 
-			for (int i = T1 - annPos - add; i < T2 - annPos - add; i++) {
-				if (sign) {
-					if (pSpec[i] > 0) continue;
-				}
-				else {
-					if (pSpec[i] < 0) continue;
-				}
-
-				T = i + annPos + add;
-				break;
+		for (int i = T1 - annPos - add; i < T2 - annPos - add; i++) {
+			if (sign) {
+				if (pSpec[i] > 0) continue;
+			}
+			else {
+				if (pSpec[i] < 0) continue;
 			}
 
-			//check for T wave symetry//////////////////////////
-			double ratio;
-			if (T2 - T < T - T1) ratio = double(T2 - T) / double(T - T1);
-			else ratio = double(T - T1) / double(T2 - T);
-			////////////////////////////////////////////////////
+			T = i + annPos + add;
+			break;
+		}
 
-			if (ratio < 0.4) { //not a T wave
-				tWave.push_back(0);
-				tWave.push_back(0);
-				tWave.push_back(0);
-				t_wave = false;
-			}
-			else {
-				//adjust center of T wave
-				//smooth it with gaussian, Find max ?
-				//cwt.ToTxt(L"debugS.txt",data+annPos+add,size);
-				int T_cntr = _findTMax(data + T1, T2 - T1);
-				if (T_cntr != -1) {
-					T_cntr += T1;
-					if (abs((T_cntr - T1) - ((T2 - T1) / 2)) < abs((T - T1) - ((T2 - T1) / 2)))  //which is close to center 0-cross or T max
-						T = T_cntr;
-				}
+		//check for T wave symetry//////////////////////////
+		double ratio;
+		if (T2 - T < T - T1) ratio = double(T2 - T) / double(T - T1);
+		else ratio = double(T - T1) / double(T2 - T);
+		////////////////////////////////////////////////////
 
-				tWaves++;
-				tWave.push_back(T1);
-				tWave.push_back(T);
-				tWave.push_back(T2);
+		if (ratio < 0.4) //not a T wave
+			t_wave = false;
+		else {
+			//adjust center of T wave
+			//smooth it with gaussian, Find max ?
+			//cwt.ToTxt(L"debugS.txt",data+annPos+add,size);
+			int T_cntr = _findTMax(data + T1, T2 - T1);
+			if (T_cntr != -1) {
+				T_cntr += T1;
+				if (abs((T_cntr - T1) - ((T2 - T1) / 2)) < abs((T - T1) - ((T2 - T1) / 2)))  //which is close to center 0-cross or T max
+					T = T_cntr;
 			}
+
+			tWave[0] = T1;
+			tWave[1] = T;
+			tWave[2] = T2;
 		}
-		else { //no T wave???    empty (QRS) <-------> (QRS)
-			tWave.push_back(0);
-			tWave.push_back(0);
-			tWave.push_back(0);
-		}
-		T = -1;
-		///////////////search for TWAVE///////////////////////////////////////////////////////////
-		cwt.close();
+	}
+	///////////////search for TWAVE///////////////////////////////////////////////////////////
 
 
 
 
 
-		///////////////search for PWAVE///////////////////////////////////////////////////////////
+	///////////////search for PWAVE///////////////////////////////////////////////////////////
 
-		size = annotations[n * 2 + 2][0] - annotations[n * 2 + 1][0];  //n   size of  (QRS) <----> (QRS)
+	size = annotations.sample(n * 2 + 2) - annotations.sample(n * 2 + 1);  //n   size of  (QRS) <----> (QRS)
 
-		if (sampleRate*_hdr.maxPQ < size)
-			size = int(sampleRate * _hdr.maxPQ);
+	if (sampleRate*_hdr.maxPQ < size)
+		size = int(sampleRate * _hdr.maxPQ);
 
-		if (t_wave) {
-			if (T2 > annotations[n * 2 + 2][0] - size - int(0.04*sampleRate))   // pwave wnd far from Twave at least on 0.02sec
-				size -= T2 - (annotations[n * 2 + 2][0] - size - int(0.04 * sampleRate));
-		}
-		const int size23 = (annotations[n * 2 + 2][0] - annotations[n * 2 + 1][0]) - size;
+	if (t_wave) {
+		if (T2 > annotations.sample(n * 2 + 2) - size - int(0.04*sampleRate))   // pwave wnd far from Twave at least on 0.02sec
+			size -= T2 - (annotations.sample(n * 2 + 2) - size - int(0.04 * sampleRate));
+	}
+	const int size23 = (annotations.sample(n * 2 + 2) - annotations.sample(n * 2 + 1)) - size;
 
-		//size -= 0.02*sr;   //impresize QRS begin detection
-		if (size <= 0.03*sampleRate) {
-			pWave.push_back(0);
-			pWave.push_back(0);
-			pWave.push_back(0);
-			continue;
-		}
+	//size -= 0.02*sr;   //impresize QRS begin detection
+	if (size <= 0.03*sampleRate)
+		return;
 
 
-		//avg = Mean(data+annPos+size23,size);                     //avrg extension on boundaries
-		//lvl = data[annPos+size23];
-		//rvl = data[annPos+size23+size-1];
-		cwt.init(size, ContinuousWaveletTransform::GAUS1, 0, sampleRate);                                        //6-Gauss1 wlet
-		pSpec = cwt.Transform(data + annPos + size23, _hdr.pFreq);//,false,lvl,rvl);    //9Hz transform  pspec = size-2/3size
+	//avg = Mean(data+annPos+size23,size);                     //avrg extension on boundaries
+	//lvl = data[annPos+size23];
+	//rvl = data[annPos+size23+size-1];
+	cwt.init(size, ContinuousWaveletTransform::GAUS1, 0, sampleRate);                                        //6-Gauss1 wlet
+	pSpec = cwt.Transform(data + annPos + size23, _hdr.pFreq);//,false,lvl,rvl);    //9Hz transform  pspec = size-2/3size
 
-		//cwt.ToTxt(L"debugS.txt",data+annPos+size23,size);
-		//cwt.ToTxt(L"debugC.txt",pspec,size);
+	//cwt.ToTxt(L"debugS.txt",data+annPos+size23,size);
+	//cwt.ToTxt(L"debugC.txt",pspec,size);
 
-		MinMax(pSpec, size, min, max);
-		for (int i = 0; i < size; i++) {
-			if (abs(pSpec[i] - min) < FLOAT_EQ_ERR) P1 = i + annPos + size23;
-			if (abs(pSpec[i] - max) < FLOAT_EQ_ERR) P2 = i + annPos + size23;
-		}
-		if (P1 > P2) std::swap(P1, P2);
-
-		//additional constraints on [P1 P P2] duration, symmetry, PQ interval
-		bool p_wave = false;
-		if ((pSpec[P1 - annPos - size23] < 0 && pSpec[P2 - annPos - size23] > 0) || (pSpec[P1 - annPos - size23] > 0 && pSpec[P2 - annPos - size23] < 0))
-			p_wave = true;
-		if (p_wave) {
-			if (double(P2 - P1) >= 0.03*sampleRate && double(P2 - P1) <= 0.15*sampleRate) { //check for P wave duration  9Hz0.03 5Hz0.05
-				if (double(annotations[n * 2 + 2][0] - P1) >= _hdr.minPQ*sampleRate && double(annotations[n * 2 + 2][0] - P1) <= _hdr.maxPQ*sampleRate)
-					p_wave = true;
-				else
-					p_wave = false;
-			}
+	MinMax(pSpec, size, min, max);
+	for (int i = 0; i < size; i++) {
+		if (abs(pSpec[i] - min) < FLOAT_EQ_ERR) P1 = i + annPos + size23;
+		if (abs(pSpec[i] - max) < FLOAT_EQ_ERR) P2 = i + annPos + size23;
+	}
+	if (P1 > P2) std::swap(P1, P2);
+
+	//additional constraints on [P1 P P2] duration, symmetry, PQ interval
+	bool p_wave = false;
+	if ((pSpec[P1 - annPos - size23] < 0 && pSpec[P2 - annPos - size23] > 0) || (pSpec[P1 - annPos - size23] > 0 && pSpec[P2 - annPos - size23] < 0))
+		p_wave = true;
+	if (p_wave) {
+		if (double(P2 - P1) >= 0.03*sampleRate && double(P2 - P1) <= 0.15*sampleRate) { //check for P wave duration  9Hz0.03 5Hz0.05
+			if (double(annotations.sample(n * 2 + 2) - P1) >= _hdr.minPQ*sampleRate && double(annotations.sample(n * 2 + 2) - P1) <= _hdr.maxPQ*sampleRate)
+				p_wave = true;
 			else
 				p_wave = false;
 		}
+		else
+			p_wave = false;
+	}
 
-		if (p_wave) {
-			if (pSpec[P1 - annPos - size23] > 0) sign = true;
-			else sign = false;
-
-			for (int i = P1 - annPos - size23; i < P2 - annPos - size23; i++) {
-				if (sign) {
-					if (pSpec[i] > 0) continue;
-				}
-				else {
-					if (pSpec[i] < 0) continue;
-				}
+	if (p_wave) {
+		if (pSpec[P1 - annPos - size23] > 0) sign = true;
+		else sign = false;
 
-				P = i + annPos + size23;
-				break;
+		for (int i = P1 - annPos - size23; i < P2 - annPos - size23; i++) {
+			if (sign) {
+				if (pSpec[i] > 0) continue;
+			}
+			else {
+				if (pSpec[i] < 0) continue;
 			}
 
-			//check for T wave symetry//////////////////////////
-			double ratio;
-			if (P2 - P < P - P1) ratio = double(P2 - P) / double(P - P1);
-			else ratio = double(P - P1) / double(P2 - P);
-			////////////////////////////////////////////////////
+			P = i + annPos + size23;
+			break;
+		}
 
-			if (ratio < 0.4) { //not a P wave
-				pWave.push_back(0);
-				pWave.push_back(0);
-				pWave.push_back(0);
-			}
-			else {
-				pWaves++;
-				pWave.push_back(P1);
-				pWave.push_back(P);
-				pWave.push_back(P2);
+		//check for T wave symetry//////////////////////////
+		double ratio;
+		if (P2 - P < P - P1) ratio = double(P2 - P) / double(P - P1);
+		else ratio = double(P - P1) / double(P2 - P);
+		////////////////////////////////////////////////////
+
+		if (ratio >= 0.4) { //else not a P wave
+			pWave[0] = P1;
+			pWave[1] = P;
+			pWave[2] = P2;
+		}
+	}
+	///////////////search for PWAVE///////////////////////////////////////////////////////////
+}
+
+AnnotationTable* Annotator::getPTU(const double *data, const int length, const double sampleRate, AnnotationTable &annotations,
+                                   int threads)
+{
+	const int qrsNum = annotations.getSize() / 2;
+	const int *samples = annotations.getSamples();
+	int *types = annotations.getTypes();
+	const int *aux = annotations.getAux();
+	int size, annPos;
+	const int beats = std::max(0, qrsNum - 1);          //RR intervals
+	std::vector <int> pWave(3 * size_t(beats), 0);
+	std::vector <int> tWave(3 * size_t(beats), 0);      //Twave [ ( , T , ) ]
+	std::vector <char> maNs(size_t(beats), 0);          //MA noise in the RR interval, no P,T
+
+	int maNum = 0;
+	for (int n = 0; n < beats; n++) {
+		for (int i = maNum; i < int(_ma.size()); i++) {
+			if (_ma[i] > samples[n * 2 + 1] && _ma[i] < samples[n * 2 + 2]) {
+				maNum++;
+				maNs[n] = 1;
+				break;
 			}
 		}
-		else {
-			pWave.push_back(0);
-			pWave.push_back(0);
-			pWave.push_back(0);
+	}
+
+	//RR intervals shared by threads workers (0 = all cores) with a CWT workspace each, the P,T
+	//slots of a beat are its own so the annotation does not depend on the schedule
+	if (threads <= 0)
+		threads = int(std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, beats));
+
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		ContinuousWaveletTransform cwt;                  //workspace reused by the beats of this worker, see init()
+		for (int n = next++; n < beats; n = next++) {
+			if (!maNs[n])
+				_getPT(data, sampleRate, annotations, n, cwt, &tWave[3 * n], &pWave[3 * n]);
 		}
-		P1 = -1;
-		P = -1;
-		P2 = -1;
-		///////////////search for PWAVE///////////////////////////////////////////////////////////
-		cwt.close();
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
 
+	int tWaves = 0;
+	int pWaves = 0;
+	for (int n = 0; n < beats; n++) {
+		if (tWave[3 * n]) tWaves++;
+		if (pWave[3 * n]) pWaves++;
 	}
 
 	/////////////////get q,r,s peaks//////////////////////////////////////////////////////////
@@ -729,8 +668,8 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 	denoise.init(buff, length, sampleRate);
 	if (denoise.LFDenoise()) {
 		for (int n = 0; n < qrsNum; n++) {
-			annPos = annotations[n * 2][0];   //PQ
-			size = annotations[n * 2 + 1][0] - annotations[n * 2][0] + 1; //PQ-Jpnt, including Jpnt
+			annPos = samples[n * 2];   //PQ
+			size = samples[n * 2 + 1] - samples[n * 2] + 1; //PQ-Jpnt, including Jpnt
 
 			double* pBuff = &buff[annPos];
 
@@ -745,7 +684,7 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 						Q = S;
 						S = -1;
 
-						size = annotations[n * 2 + 1][0] - R + 1;  //including Jpnt
+						size = samples[n * 2 + 1] - R + 1;  //including Jpnt
 						pBuff = &buff[R];
 						S = _find_s(pBuff, size, 0.05);
 						if (S != -1) S += R;
@@ -769,7 +708,7 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 				size = R - annPos + 1; //including R peak
 				Q = _find_q(pBuff, size, 0.05);
 				if (Q != -1) Q += annPos;
-				size = annotations[n * 2 + 1][0] - R + 1;  //including Jpnt
+				size = samples[n * 2 + 1] - R + 1;  //including Jpnt
 				pBuff = &buff[R];
 				S = _find_s(pBuff, size, 0.05);
 				if (S != -1) S += R;
@@ -778,7 +717,7 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 
 			//put peaks to qrsPeaks vector
 			if (R == -1 && S == -1) { //no peaks
-				annotations[n * 2][1] = 16;   //ARTEFACT
+				types[n * 2] = 16;   //ARTEFACT
 				//remove P,T
 				if (n != 0) {
 					if (pWave[3 * (n - 1)]) {
@@ -836,71 +775,44 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 	maNum = 0;
 
 	//Pwave vec size = Twave vec size
-	_annNum = pWaves * 3 + qrsNum * 2 + peaksNum + tWaves * 3 + int(_ma.size());   //P1 P P2 [QRS] T1 T T2  noise annotation
-	if (_annNum > qrsNum)                        //42-(p 43-p) 24-Pwave
+	const int annNum = pWaves * 3 + qrsNum * 2 + peaksNum + tWaves * 3 + int(_ma.size());   //P1 P P2 [QRS] T1 T T2  noise annotation
+	_ann.clear();
+	if (annNum > qrsNum)                        //42-(p 43-p) 24-Pwave
 	{                                           //44-(t 45-t) 27-Twave
-		_ann = new int*[_annNum];                    // [samps] [type] [?aux data]
-		for (int i = 0; i < _annNum; i++)
-			_ann[i] = new int[3];
+		_ann.reserve(annNum);                    // [samps] [type] [?aux data]
 
-		int index = 0; //index to ANN
 		int qIndex = 0;  //index to qrsANN
 
 		for (int i = 0; i < int(tWave.size()); i += 3) {   //Twave=Pwaves=qrsPeaks size
 				//QRS complex
-			_ann[index][0] = annotations[qIndex][0];           //(QRS
-			_ann[index][1] = annotations[qIndex][1];           //
-			_ann[index++][2] = annotations[qIndex++][2];       //aux
-			if (qrsPeaks[i]) { //q
-				_ann[index][0] = qrsPeaks[i];
-				_ann[index][1] = qrsTypes[i];
-				_ann[index++][2] = -1;              //no aux
-			}
-			if (qrsPeaks[i + 1]) { //r
-				_ann[index][0] = qrsPeaks[i + 1];
-				_ann[index][1] = qrsTypes[i + 1];
-				_ann[index++][2] = -1;              //no aux
-			}
-			if (qrsPeaks[i + 2]) { //s
-				_ann[index][0] = qrsPeaks[i + 2];
-				_ann[index][1] = qrsTypes[i + 2];
-				_ann[index++][2] = -1;              //no aux
-			}
-			_ann[index][0] = annotations[qIndex][0];           //QRS)
-			_ann[index][1] = annotations[qIndex][1];           //
-			_ann[index++][2] = annotations[qIndex++][2];       //aux
+			_ann.add(samples[qIndex], types[qIndex], aux[qIndex]);     //(QRS
+			qIndex++;
+			if (qrsPeaks[i])          //q
+				_ann.add(qrsPeaks[i], qrsTypes[i]);
+			if (qrsPeaks[i + 1])      //r
+				_ann.add(qrsPeaks[i + 1], qrsTypes[i + 1]);
+			if (qrsPeaks[i + 2])      //s
+				_ann.add(qrsPeaks[i + 2], qrsTypes[i + 2]);
+			_ann.add(samples[qIndex], types[qIndex], aux[qIndex]);     //QRS)
+			qIndex++;
 
 			//T wave
 			if (tWave[i]) {
-				_ann[index][0] = tWave[i];                //(t
-				_ann[index][1] = 44;
-				_ann[index++][2] = -1;                    //no aux
-				_ann[index][0] = tWave[i + 1];              //T
-				_ann[index][1] = 27;
-				_ann[index++][2] = -1;                    //no aux
-				_ann[index][0] = tWave[i + 2];              //t)
-				_ann[index][1] = 45;
-				_ann[index++][2] = -1;                    //no aux
+				_ann.add(tWave[i], 44);                   //(t
+				_ann.add(tWave[i + 1], 27);               //T
+				_ann.add(tWave[i + 2], 45);               //t)
 			}
 			//P wave
 			if (pWave[i]) {
-				_ann[index][0] = pWave[i];                //(t
-				_ann[index][1] = 42;
-				_ann[index++][2] = -1;                    //no aux
-				_ann[index][0] = pWave[i + 1];              //T
-				_ann[index][1] = 24;
-				_ann[index++][2] = -1;                    //no aux
-				_ann[index][0] = pWave[i + 2];              //t)
-				_ann[index][1] = 43;
-				_ann[index++][2] = -1;                    //no aux
+				_ann.add(pWave[i], 42);                   //(p
+				_ann.add(pWave[i + 1], 24);               //P
+				_ann.add(pWave[i + 2], 43);               //p)
 			}
 
 			if (!tWave[i] && !pWave[i]) {          //check for MA noise
 				for (int m = maNum; m < int(_ma.size()); m++) {
-					if (_ma[m] > annotations[qIndex - 1][0] && _ma[m] < annotations[qIndex][0]) {
-						_ann[index][0] = _ma[m];      //Noise
-						_ann[index][1] = 14;
-						_ann[index++][2] = -1;       //no aux
+					if (_ma[m] > samples[qIndex - 1] && _ma[m] < samples[qIndex]) {
+						_ann.add(_ma[m], 14);              //Noise
 						maNum++;
 						break;
 					}
@@ -910,56 +822,46 @@ int** Annotator::getPTU(const double *data, const int length, const double sampl
 
 		//last QRS complex
 		const int ii = 3 * (qrsNum - 1);
-		_ann[index][0] = annotations[qIndex][0];           //(QRS
-		_ann[index][1] = annotations[qIndex][1];           //
-		_ann[index++][2] = annotations[qIndex++][2];       //aux
-		if (qrsPeaks[ii]) { //q
-			_ann[index][0] = qrsPeaks[ii];
-			_ann[index][1] = qrsTypes[ii];
-			_ann[index++][2] = -1;              //no aux
-		}
-		if (qrsPeaks[ii + 1]) { //r
-			_ann[index][0] = qrsPeaks[ii + 1];
-			_ann[index][1] = qrsTypes[ii + 1];
-			_ann[index++][2] = -1;              //no aux
-		}
-		if (qrsPeaks[ii + 2]) { //s
-			_ann[index][0] = qrsPeaks[ii + 2];
-			_ann[index][1] = qrsTypes[ii + 2];
-			_ann[index++][2] = -1;              //no aux
-		}
-		_ann[index][0] = annotations[qIndex][0];           //QRS)
-		_ann[index][1] = annotations[qIndex][1];           //
-		_ann[index++][2] = annotations[qIndex++][2];       //aux
+		_ann.add(samples[qIndex], types[qIndex], aux[qIndex]);         //(QRS
+		qIndex++;
+		if (qrsPeaks[ii])             //q
+			_ann.add(qrsPeaks[ii], qrsTypes[ii]);
+		if (qrsPeaks[ii + 1])         //r
+			_ann.add(qrsPeaks[ii + 1], qrsTypes[ii + 1]);
+		if (qrsPeaks[ii + 2])         //s
+			_ann.add(qrsPeaks[ii + 2], qrsTypes[ii + 2]);
+		_ann.add(samples[qIndex], types[qIndex], aux[qIndex]);         //QRS)
+		qIndex++;
 
 		//check if noise after last qrs
 		if (maNum < int(_ma.size())) {
-			if (_ma[maNum] > annotations[qIndex - 1][0]) {
-				_ann[index][0] = _ma[maNum];      //Noise
-				_ann[index][1] = 14;
-				_ann[index][2] = -1;
-			}
+			if (_ma[maNum] > samples[qIndex - 1])
+				_ann.add(_ma[maNum], 14);      //Noise
 		}
 
-		return _ann;
+		return &_ann;
 	}
 	return nullptr;
+
 }
 //-----------------------------------------------------------------------------
 
-void Annotator::addAnnotationOffset(int add) const
+void Annotator::addAnnotationOffset(int add)
 {
-	for (int i = 0; i < _qrsNum; i++)
-		_qrsAnn[i][0] += add;
+	int *samples = _qrsAnn.getSamples();
+	for (int i = 0; i < _qrsAnn.getSize(); i++)
+		samples[i] += add;
 
-	for (int i = 0; i < _annNum; i++)
-		_ann[i][0] += add;
+	samples = _ann.getSamples();
+	for (int i = 0; i < _ann.getSize(); i++)
+		samples[i] += add;
 }
 
 // SaveAnnotation (**aux)   aux data
-bool Annotator::SaveAnnotation(const char *name, int **ann, int num)
+bool Annotator::SaveAnnotation(const char *name, AnnotationView ann)
 {
 	int samples;
+	const int num = ann.getSize();
 	unsigned short annCode = 0;
 	char buff[1024];
 
@@ -967,19 +869,19 @@ bool Annotator::SaveAnnotation(const char *name, int **ann, int num)
 	fopen_s(&fp, name, "wt");
 	if (!fp) return false;
 
-	samples = ann[0][0];
+	samples = ann.sample(0);
 	buff[0] = 0;
 	buff[1] = char(0xEC);
 
 	fwrite(buff, 2, 1, fp);
 	fwrite(&samples, sizeof(samples), 1, fp);
-	unsigned short type = ann[0][1];
+	unsigned short type = ann.type(0);
 	annCode |= (type << 10);
 	fwrite(&annCode, sizeof(short), 1, fp);
 	for (int i = 1; i < num; i++) {
-		samples = ann[i][0] - ann[i - 1][0];
+		samples = ann.sample(i) - ann.sample(i - 1);
 		annCode = 0;
-		type = ann[i][1];
+		type = ann.type(i);
 		if (samples > 1023) {
 			fwrite(buff, 2, 1, fp);
 			fwrite(&samples, sizeof(samples), 1, fp);
@@ -997,8 +899,9 @@ bool Annotator::SaveAnnotation(const char *name, int **ann, int num)
 	return true;
 }
 
-bool Annotator::getRRSequence(int **annotations, const int num, const double sampleRate, std::vector<double> *RR, std::vector<int> *RR_position) const
+bool Annotator::getRRSequence(AnnotationView annotations, const double sampleRate, std::vector<double> *RR, std::vector<int> *RR_position) const
 {
+	const int num = annotations.getSize();
 	int add = -1;
 	double r1 = 0, r2 = 0;
 
@@ -1009,15 +912,15 @@ bool Annotator::getRRSequence(int **annotations, const int num, const double sam
 	bool rrs = true;
 	int rNum = 0, sNum = 0;
 	for (int i = 0; i < num; i++) {
-		if (annotations[i][1] == 47 || annotations[i][1] == 48) rNum++;
-		else if (annotations[i][1] == 49 || annotations[i][1] == 50) sNum++;
+		if (annotations.type(i) == 47 || annotations.type(i) == 48) rNum++;
+		else if (annotations.type(i) == 49 || annotations.type(i) == 50) sNum++;
 	}
 	if (int(1.2f*float(rNum)) < sNum)
 		rrs = false;  //R peaks less than S ones
 
 
 	for (int i = 0; i < num; i++) {
-		switch (annotations[i][1]) {
+		switch (annotations.type(i)) {
 		case 0:    //non beats
 		case 15:   //q
 		case 17:   //Q
@@ -1062,48 +965,48 @@ bool Annotator::getRRSequence(int **annotations, const int num, const double sam
 			//annotation on RRs peaks
 			if (rrs)
 			{
-				if (i + 1 < num && (annotations[i + 1][1] == 47 || annotations[i + 1][1] == 48))  //r only
-					r2 = annotations[i + 1][0];
-				else if (i + 2 < num && (annotations[i + 2][1] == 47 || annotations[i + 2][1] == 48))  //q,r
-					r2 = annotations[i + 2][0];
+				if (i + 1 < num && (annotations.type(i + 1) == 47 || annotations.type(i + 1) == 48))  //r only
+					r2 = annotations.sample(i + 1);
+				else if (i + 2 < num && (annotations.type(i + 2) == 47 || annotations.type(i + 2) == 48))  //q,r
+					r2 = annotations.sample(i + 2);
 				else //(ann[i][1]==N,ECT,...)  //no detected R only S
-					r2 = annotations[i][0];
+					r2 = annotations.sample(i);
 
-				if (add + 1 < num && (annotations[add + 1][1] == 47 || annotations[add + 1][1] == 48))
-					r1 = annotations[add + 1][0];
-				else if (add + 2 < num && (annotations[add + 2][1] == 47 || annotations[add + 2][1] == 48))
-					r1 = annotations[add + 2][0];
+				if (add + 1 < num && (annotations.type(add + 1) == 47 || annotations.type(add + 1) == 48))
+					r1 = annotations.sample(add + 1);
+				else if (add + 2 < num && (annotations.type(add + 2) == 47 || annotations.type(add + 2) == 48))
+					r1 = annotations.sample(add + 2);
 				else //(ann[add][1]==N,ECT,...) //no detected R only S
-					r1 = annotations[add][0];
+					r1 = annotations.sample(add);
 			}
 			//annotation on S peaks
 			else
 			{
-				if (i + 1 < num && (annotations[i + 1][1] == 40))  //N)
-					r2 = annotations[i][0];
-				else if (i + 1 < num && (annotations[i + 1][1] == 49 || annotations[i + 1][1] == 50))  //Sr
-					r2 = annotations[i + 1][0];
-				else if (i + 2 < num && (annotations[i + 2][1] == 49 || annotations[i + 2][1] == 50))  //rS
-					r2 = annotations[i + 2][0];
-				else if (i + 3 < num && (annotations[i + 3][1] == 49 || annotations[i + 3][1] == 50))  //errQ rS
-					r2 = annotations[i + 3][0];
-				else if (i + 1 < num && (annotations[i + 1][1] == 47 || annotations[i + 1][1] == 48))  //no S
-					r2 = annotations[i + 1][0];
-				else if (i + 2 < num && (annotations[i + 2][1] == 47 || annotations[i + 2][1] == 48))  //no S
-					r2 = annotations[i + 2][0];
-
-				if (add + 1 < num && (annotations[add + 1][1] == 40))  //N)
-					r1 = annotations[add][0];
-				else if (add + 1 < num && (annotations[add + 1][1] == 49 || annotations[add + 1][1] == 50))
-					r1 = annotations[add + 1][0];
-				else if (add + 2 < num && (annotations[add + 2][1] == 49 || annotations[add + 2][1] == 50))
-					r1 = annotations[add + 2][0];
-				else if (add + 3 < num && (annotations[add + 3][1] == 49 || annotations[add + 3][1] == 50))
-					r1 = annotations[add + 3][0];
-				else if (add + 1 < num && (annotations[add + 1][1] == 47 || annotations[add + 1][1] == 48))  //no S
-					r1 = annotations[add + 1][0];
-				else if (add + 2 < num && (annotations[add + 2][1] == 47 || annotations[add + 2][1] == 48))  //no S
-					r1 = annotations[add + 2][0];
+				if (i + 1 < num && (annotations.type(i + 1) == 40))  //N)
+					r2 = annotations.sample(i);
+				else if (i + 1 < num && (annotations.type(i + 1) == 49 || annotations.type(i + 1) == 50))  //Sr
+					r2 = annotations.sample(i + 1);
+				else if (i + 2 < num && (annotations.type(i + 2) == 49 || annotations.type(i + 2) == 50))  //rS
+					r2 = annotations.sample(i + 2);
+				else if (i + 3 < num && (annotations.type(i + 3) == 49 || annotations.type(i + 3) == 50))  //errQ rS
+					r2 = annotations.sample(i + 3);
+				else if (i + 1 < num && (annotations.type(i + 1) == 47 || annotations.type(i + 1) == 48))  //no S
+					r2 = annotations.sample(i + 1);
+				else if (i + 2 < num && (annotations.type(i + 2) == 47 || annotations.type(i + 2) == 48))  //no S
+					r2 = annotations.sample(i + 2);
+
+				if (add + 1 < num && (annotations.type(add + 1) == 40))  //N)
+					r1 = annotations.sample(add);
+				else if (add + 1 < num && (annotations.type(add + 1) == 49 || annotations.type(add + 1) == 50))
+					r1 = annotations.sample(add + 1);
+				else if (add + 2 < num && (annotations.type(add + 2) == 49 || annotations.type(add + 2) == 50))
+					r1 = annotations.sample(add + 2);
+				else if (add + 3 < num && (annotations.type(add + 3) == 49 || annotations.type(add + 3) == 50))
+					r1 = annotations.sample(add + 3);
+				else if (add + 1 < num && (annotations.type(add + 1) == 47 || annotations.type(add + 1) == 48))  //no S
+					r1 = annotations.sample(add + 1);
+				else if (add + 2 < num && (annotations.type(add + 2) == 47 || annotations.type(add + 2) == 48))  //no S
+					r1 = annotations.sample(add + 2);
 			}
 
 			double rr = 60.0 / ((r2 - r1) / sampleRate);
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include "ecgtypes.h"
+#include "AnnotationTable.h"
+#include "ContinuousWaveletTransform.h"
 
 class Annotator
 {
@@ -17,21 +19,27 @@ public:
 			//const EcgAnnotation& operator=(const EcgAnnotation& annotation);
 
 	// Operations
-    int** getQRS(const double* data, int size, double sampleRate); //get RR's classification
-	void getEctopia(int **annotations, int qrsNum, double sampleRate) const;                                                   //classify ectopic beats
-    int** getPTU(const double *data, int length, double sampleRate, int **annotations, int qrsNum);
-
-	void addAnnotationOffset(int add) const;    //add if annotated within fromX-toX
-    static bool SaveAnnotation(const char *name, int **annotations, int num);
+    //tables are owned by the Annotator, valid until the next call or its destruction. nullptr if none found
+    AnnotationTable* getQRS(const double* data, int size, double sampleRate); //get RR's classification
+	void getEctopia(AnnotationTable &annotations, double sampleRate) const;                                                   //classify ectopic beats
+    //beats shared by threads workers (0 = all cores)
+    AnnotationTable* getPTU(const double *data, int length, double sampleRate, AnnotationTable &annotations, int threads = 0);
+
+	void addAnnotationOffset(int add);    //add if annotated within fromX-toX
+    static bool SaveAnnotation(const char *name, AnnotationView annotations);
 	//bool  ReadANN(wchar_t *);
 
-    bool getRRSequence(int **annotations, int num, double sampleRate, std::vector<double> *RR, std::vector<int> *RR_position) const;
+    bool getRRSequence(AnnotationView annotations, double sampleRate, std::vector<double> *RR, std::vector<int> *RR_position) const;
+    //multiple of samples a record may be cut at without moving the 2 sec threshold windows of the
+    //0-30Hz filter of getQRS or the baseline scale of getPTU: a part starting there is filtered as
+    //the whole record past its edges
+    static int getFilterAlignment(double sampleRate);
 
 	// Access
 	 int getQRSNumber() const;
 	 int getAnnotationSize() const;
-	 int** getAnnotation() const;
-	 int** getQRSAnnotation() const;
+	 AnnotationView getAnnotation() const;
+	 AnnotationView getQRSAnnotation() const;
 	 char** getAuxData() const;
 	 ANN_HEADER* getAnnotationHeader();
 
@@ -41,8 +49,9 @@ private:
     Annotator(const Annotator& annotation) = delete;
     const Annotator& operator=(const Annotator& annotation) = delete;
 
-	static bool _isNoise(const double *data, int window);        //check for noise in window len
     bool _filter30Hz(double *data, int size, double sampleRate) const;    //0-30Hz removal
+    void _getPT(const double *data, double sampleRate, AnnotationView annotations, int n, ContinuousWaveletTransform &cwt,
+                int *tWave, int *pWave) const;    //P,T waves of RR interval n
 
 	static void _find_RS(const double *data, int size, int &R, int &S, double err = 0.0);  //find RS or QR
 	int _find_r(const double *data, int size, double err = 0.0) const;  //find small r in PQ-S
@@ -53,34 +62,30 @@ private:
 
 	ANN_HEADER _hdr;                    //annotation ECG params
 
-	int **_ann;
-	int _annNum;
-	int **_qrsAnn;
-	int _qrsNum;
+	AnnotationTable _ann;                 //QRS, peaks, P, T waves and noise
+	AnnotationTable _qrsAnn;              //QRS onset, offset pairs
 	std::vector <int> _ma;                //MA noise
 	int _auxNum;
 	char **_aux;                     //auxiliary ECG annotation data
 	static std::string _filterPath;
 };
 
-/*                      0           1             2
-		int **ANN [x][samples][annotation type][aux data index]
+/*
+		AnnotationTable rows [samples][annotation type][aux data index]
 
-		wchar_t *dir = "c:\\dir_for_fwt_filters\\filters";
 		double *sig;   //signal massive
 		double SR;     //sampling rate of the signal
 		int size;   //size of the signal
 
-		EcgAnnotation ann;
+		Annotator ann;
 
-		int **qrsAnn;  //qrs annotation massive
-		qrsAnn = ann.GetQRS(sig,size,SR,dir);       //get QRS complexes
-		//qrsAnn = ann->GetQRS(psig,size,SR,umess,qNOISE);    //get QRS complexes if signal is quite noisy
+		AnnotationTable *qrsAnn;  //qrs annotation, owned by ann
+		qrsAnn = ann.getQRS(sig,size,SR);       //get QRS complexes
 
-		int **ANN; //QRS + PT annotation
+		AnnotationTable *ANN; //QRS + PT annotation
 		if(qrsAnn) {
-				ann.GetEctopics(qrsAnn,ann->GetQrsNumber(),SR);     //label Ectopic beats
-				ANN = ann.GetPTU(sig,size,SR,dir,qrsAnn,ann.GetQrsNumber());   //find P,T waves
+				ann.getEctopia(*qrsAnn,SR);     //label Ectopic beats
+				ANN = ann.getPTU(sig,size,SR,*qrsAnn);   //find P,T waves
 		}
 */
 
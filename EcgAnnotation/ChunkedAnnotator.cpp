@@ -0,0 +1,109 @@
+#include <algorithm>
+#include "ChunkedAnnotator.h"
+
+ChunkedAnnotator::ChunkedAnnotator(PANN_HEADER p) : _annotator(p), _chunk(300.0), _overlap(10.0), _threads(0), _qrsNum(0),
+_lastOffset(-1)
+{
+}
+
+void ChunkedAnnotator::setChunk(double chunk, double overlap)
+{
+	_chunk = chunk;
+	_overlap = overlap;
+}
+
+void ChunkedAnnotator::setThreads(int threads)
+{
+	_threads = threads;
+}
+
+int ChunkedAnnotator::getQRSNumber() const
+{
+	return _qrsNum;
+}
+
+AnnotationView ChunkedAnnotator::getAnnotation() const
+{
+	return _ann;
+}
+
+ANN_HEADER* ChunkedAnnotator::getAnnotationHeader()
+{
+	return _annotator.getAnnotationHeader();
+}
+
+int ChunkedAnnotator::annotate(const double *data, int length, double sampleRate, const RowSink &rowSink)
+{
+	return _annotate(data, nullptr, length, sampleRate, rowSink);
+}
+
+int ChunkedAnnotator::annotate(const Reader &reader, int length, double sampleRate, const RowSink &rowSink)
+{
+	return _annotate(nullptr, reader, length, sampleRate, rowSink);
+}
+
+int ChunkedAnnotator::_annotate(const double *data, const Reader &reader, int length, double sampleRate,
+                                const RowSink &rowSink)
+{
+	_ann.clear();
+	_qrsNum = 0;
+	_lastOffset = -1;
+
+	const int chunk = std::max(1, int(_chunk * sampleRate));
+	const int overlap = std::max(0, int(_overlap * sampleRate));
+	const int alignment = Annotator::getFilterAlignment(sampleRate);
+
+	for (int start = 0; start < length; start += chunk) {
+		const int from = std::max(0, start - overlap) / alignment * alignment;   //filter windows of the whole record
+		const int to = (length - start > chunk + overlap) ? start + chunk + overlap : length;
+		const int end = (length - start > chunk) ? start + chunk : length;     //QRS onsets kept before
+
+		if (rowSink)
+			_ann.clear();
+		const int rows = _ann.getSize();
+
+		if (data)
+			_annotateChunk(data + from, from, to - from, end, sampleRate);
+		else {
+			_buffer.resize(size_t(to - from));
+			if (reader(_buffer.data(), from, to - from) == false)
+				break;
+			_annotateChunk(_buffer.data(), from, to - from, end, sampleRate);
+		}
+
+		if (rowSink)
+			rowSink(_ann.getView(rows));
+	}
+	return _qrsNum;
+}
+
+//beat rows of the chunk start at its QRS onset row, in the order of the QRS table
+void ChunkedAnnotator::_annotateChunk(const double *data, int from, int count, int end, double sampleRate)
+{
+	AnnotationTable *qrs = _annotator.getQRS(data, count, sampleRate);
+	if (!qrs)
+		return;
+	_annotator.getEctopia(*qrs, sampleRate);
+
+	AnnotationView rows = *qrs;
+	if (_annotator.getPTU(data, count, sampleRate, *qrs, _threads))
+		rows = _annotator.getAnnotation();
+	const AnnotationView beats = *qrs;
+
+	int beat = -1;
+	bool keep = false;
+	for (int i = 0; i < rows.getSize(); i++) {
+		const int next = beat + 1;
+		if (2 * next < beats.getSize() && rows.sample(i) == beats.sample(2 * next) && rows.type(i) == beats.type(2 * next)) {
+			beat = next;
+			const int onset = beats.sample(2 * beat) + from;
+			keep = onset > _lastOffset && onset < end;
+			if (keep) {
+				_lastOffset = beats.sample(2 * beat + 1) + from;
+				_qrsNum++;
+			}
+		}
+		if (keep)
+			_ann.add(rows.sample(i) + from, rows.type(i), rows.aux(i));
+	}
+}
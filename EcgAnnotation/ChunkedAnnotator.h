@@ -0,0 +1,58 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "Annotator.h"
+
+//Annotator over a long record (multi-day Holter) chunk by chunk: getQRS, getEctopia and getPTU run on
+//chunk seconds of signal with overlap seconds more on either side. The leading overlap is extended back
+//to a multiple of Annotator::getFilterAlignment(), so the 2 sec threshold windows of the 0-30Hz filter
+//and the baseline scale fall on the same samples as in the whole record and, once the filter edges and
+//the QRS walk settle in the overlap, the chunk is annotated as the whole record is. A beat is kept by the chunk its QRS onset
+//falls in, a beat the previous chunk already kept is dropped, and the rows of a beat (QRS, peaks,
+//T and P waves of its RR interval, noise) stay together. Working memory is set by the chunk length,
+//not the record length
+class ChunkedAnnotator
+{
+public:
+	ChunkedAnnotator(PANN_HEADER p = nullptr);
+
+	// Data
+	typedef std::function<bool(double *buffer, int from, int count)> Reader;   //count samples from sample from
+	typedef std::function<void(AnnotationView rows)> RowSink;                  //kept rows of a chunk, in order
+
+	// Operations
+	void setChunk(double chunk, double overlap);     //secs, 300 and 10 by default
+	void setThreads(int threads);                    //getPTU workers, 0 = all cores
+
+	//rows with record sample positions. With a rowSink the rows of each chunk are handed over and
+	//not kept, getAnnotation() then holds the last chunk only. returns beats annotated
+	int annotate(const double *data, int length, double sampleRate, const RowSink &rowSink = nullptr);
+	int annotate(const Reader &reader, int length, double sampleRate, const RowSink &rowSink = nullptr);
+
+	// Access
+	int getQRSNumber() const;
+	AnnotationView getAnnotation() const;
+	ANN_HEADER* getAnnotationHeader();
+
+private:
+	ChunkedAnnotator(const ChunkedAnnotator& annotator) = delete;
+	const ChunkedAnnotator& operator=(const ChunkedAnnotator& annotator) = delete;
+
+	int _annotate(const double *data, const Reader &reader, int length, double sampleRate, const RowSink &rowSink);
+	void _annotateChunk(const double *data, int from, int count, int end, double sampleRate);
+
+	Annotator _annotator;
+	AnnotationTable _ann;
+	std::vector<double> _buffer;     //chunk samples of a reader
+	double _chunk;
+	double _overlap;
+	int _threads;
+	int _qrsNum;
+	int _lastOffset;                 //QRS offset of the last beat kept
+};
+
+/*//////////////////////////////////////////////
+		ChunkedAnnotator ann;
+		ann.annotate(signal->GetData(lead), signal->GetLength(lead), signal->GetSR(lead));
+		Annotator::SaveAnnotation(name, ann.getAnnotation());
+//////////////////////////////////////////////*/
@@ -2,97 +2,76 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 #include "ContinuousWaveletTransform.h"
+#include "vectorops.h"
 
-ContinuousWaveletTransform::ContinuousWaveletTransform() : _pHDR(nullptr), _minFrequency(0), _maxFrequency(0), _frequencyInterval(0),
-                                                           _w0(0), _scaleType(LINEAR_SCALE), _wavelet(),
-                                                           _signalSize(0), _pData(nullptr),
-                                                           _pSpectrum(nullptr),
-                                                           _pReal(nullptr), _pImage(nullptr), _isPrecision(false), _precisionSize(0),
-                                                           _isPeriodicBoundary(false), _leftValue(0),
-                                                           _rightValue(0), _sampleRate(0)
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FFT_MIN_TAPS 128        //AUTO_CONVOLUTION wavelet taps from which FFT is used
+#define KERNEL_CACHE_SIZE 256   //cached wavelet kernels before the cache is flushed
+
+template <typename T>
+std::map<typename ContinuousWaveletTransformT<T>::KernelKey, std::shared_ptr<const typename ContinuousWaveletTransformT<T>::Kernel> >
+ContinuousWaveletTransformT<T>::_kernelCache;
+template <typename T>
+std::mutex ContinuousWaveletTransformT<T>::_kernelCacheMutex;
+
+ContinuousWaveletTransformBase::ContinuousWaveletTransformBase() : _minFrequency(0), _maxFrequency(0), _frequencyInterval(0),
+                                                                   _scaleType(LINEAR_SCALE)
 {
 }
 
-ContinuousWaveletTransform::~ContinuousWaveletTransform()
+template <typename T>
+ContinuousWaveletTransformT<T>::ContinuousWaveletTransformT() : _pHDR(nullptr), _w0(0), _wavelet(),
+                                                                _signalSize(0), _pData(nullptr),
+                                                                _pSpectrum(nullptr), _spectrumCapacity(0),
+                                                                _pReal(nullptr), _pImage(nullptr),
+                                                                _pFftBuffer(nullptr), _fftCapacity(0), _fftSize(0), _fftTaps(0),
+                                                                _pPadBuffer(nullptr), _padCapacity(0),
+                                                                _isPrecision(false), _precisionSize(0),
+                                                                _isPeriodicBoundary(false), _leftValue(0),
+                                                                _rightValue(0), _sampleRate(0)
 {
-	if (_pReal) free(_pReal);
-	if (_pImage) free(_pImage);
-	if (_pSpectrum) free(_pSpectrum);
 }
 
-double ContinuousWaveletTransform::_transform(int x, double scale) const
+template <typename T>
+ContinuousWaveletTransformT<T>::~ContinuousWaveletTransformT()
 {
-	double res;
-	double real = 0;
-	double image = 0;
-
-	for (int t = 0; t < _signalSize; t++) {                   //main
-		if (_isPrecision == true) {
-			if (t < x - _precisionSize)
-				t = x - (_precisionSize - 1);  //continue;
-			if (t >= _precisionSize + x)
-				break;
-		}
-
-		real += _pReal[((_signalSize - 1) - x) + t] * _pData[t];
-		if (_wavelet == MORLPOW || _wavelet == MORLFULL)
-			image += _pImage[((_signalSize - 1) - x) + t] * _pData[t];
-	}
+	if (_pSpectrum) free(_pSpectrum);
+	if (_pFftBuffer) free(_pFftBuffer);
+	if (_pPadBuffer) free(_pPadBuffer);
+}
 
-	////////////////////boundaries///////////////////////////////////////////////
-	
-	for (int i = (_signalSize - _precisionSize); i < (_signalSize - 1) - x; i++) {        // Left edge calculations
-		if (_isPeriodicBoundary) {
-			real += _pReal[i] * _pData[(_signalSize - 1) - i - x];  //IsPeriodicBoundary
-		}
-		else {
-			if (_leftValue != 0.0)
-				real += _pReal[i] * _leftValue;
-			else
-				real += _pReal[i] * _pData[0];
-		}
+// window = signal from x-(_precisionSize-1) to x+(_precisionSize-1), boundary extended
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+double ContinuousWaveletTransformT<T>::_transform(const T *window, double scale) const
+{
+	const int taps = 2 * _precisionSize - 1;
+	T real = 0;
+	T image = 0;
 
-		if (_wavelet == MORLPOW || _wavelet == MORLFULL) { //Im part for complex wavelet
-			if (_isPeriodicBoundary) {
-				image += _pImage[i] * _pData[(_signalSize - 1) - i - x];
-			}
-			else {
-				if (_leftValue != 0.0)
-					image += _pImage[i] * _leftValue;
-				else
-					image += _pImage[i] * _pData[0];
-			}
-		}
-	}
-	int q = 0;
-	for (int i = 2 * _signalSize - (x + 1); i < _signalSize + _precisionSize - 1; i++) {     // Right edge calculations
-		if (_isPeriodicBoundary)
-			real += _pReal[i] * _pData[(_signalSize - 2) - q]; //IsPeriodicBoundary
-		else {
-			if (_rightValue != 0.0)
-				real += _pReal[i] * _rightValue;
-			else
-				real += _pReal[i] * _pData[_signalSize - 1];
-		}
+	if (W == MORLPOW || W == MORLFULL)
+		Dot2(_pReal, _pImage, window, taps, real, image);
+	else
+		real = Dot(_pReal, window, taps);
 
-		if (_wavelet == MORLPOW || _wavelet == MORLFULL) {
-			if (_isPeriodicBoundary) {
-				image += _pImage[i] * _pData[(_signalSize - 2) - q];
-			}
-			else {
-				if (_rightValue != 0.0)
-					image += _pImage[i] * _rightValue;
-				else
-					image += _pImage[i] * _pData[_signalSize - 1];
-			}
-		}
-		q++;
-	}
-	////////////////////boundaries///////////////////////////////////////////////
+	return _spectrumValue<W>(real, image, scale);
+}
 
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+double ContinuousWaveletTransformT<T>::_spectrumValue(double real, double image, double scale)
+{
+	double res;
 
-	switch (_wavelet) {
+	switch (W) {
 	case MORL:
 		res = (1 / sqrt(6.28)) * real;
 		break;
@@ -114,173 +93,579 @@ double ContinuousWaveletTransform::_transform(int x, double scale) const
 	return res;
 }
 
-int ContinuousWaveletTransform::GetFreqRange() const
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+void ContinuousWaveletTransformT<T>::_waveletTap(double w, double t, double &real, double &image)
 {
-	if (_scaleType == LINEAR_SCALE)
-		return int((_maxFrequency + _frequencyInterval - _minFrequency) / _frequencyInterval);
-	if (_scaleType == LINEAR_SCALE)
-		return int((log(_maxFrequency) + _frequencyInterval - log(_minFrequency)) / _frequencyInterval);
-	return 0;
-}
-
-double ContinuousWaveletTransform::GetMinFreq() const
-{
-	return _minFrequency;
-}
-
-double ContinuousWaveletTransform::GetMaxFreq() const
-{
-	return _maxFrequency;
-}
-
-double ContinuousWaveletTransform::GetFreqInterval() const
-{
-	return _frequencyInterval;
-}
-
-int ContinuousWaveletTransform::GetScaleType() const
-{
-	return _scaleType;
-}
-
-void ContinuousWaveletTransform::init(int size, enum WAVELET wavelet, double w, double sr)
-{
-	_signalSize = size;
-
-    if (sr > 0)
-		_sampleRate = sr;
-
-	_w0 = w;
-	_pReal = static_cast<double *>(malloc(sizeof(double) * (2 * _signalSize - 1)));
-	_pImage = static_cast<double *>(malloc(sizeof(double) * (2 * _signalSize - 1)));
-	_pSpectrum = static_cast<double *>(malloc(sizeof(double) * (_signalSize)));
-	_wavelet = wavelet;
-
-	for (int i = 0; i < 2 * _signalSize - 1; i++) {
-		_pReal[i] = 0;
-		_pImage[i] = 0;
-	}
-}
+	double sn = 0, cs = 0;
 
-void  ContinuousWaveletTransform::close()
-{
-	if (_pReal) {
-		free(_pReal);
-		_pReal = nullptr;
+	if (W > INV && W < MORLFULL) {
+		sn = sin(6.28 * t);
+		cs = cos(6.28 * t);
 	}
-	if (_pImage) {
-		free(_pImage);
-		_pImage = nullptr;
+	if (W == MORLFULL) {
+		sn = sin(w * t);
+		cs = cos(w * t);
 	}
-	if (_pSpectrum) {
-		free(_pSpectrum);
-		_pSpectrum = nullptr;
-	}
-}
-/*
-float* ContinuousWaveletTransform::CwtCreateFileHeader(wchar_t *name, PCWT_HEADER hdr, enum WAVELET wavelet, double w)
-{
-	wchar_t tmp[_MAX_PATH];
 
-	int filesize;
-
-	switch (wavelet) {
+	image = 0;
+	switch (W) {
 	case MHAT:
-		wcscat(name, L"(mHat).w");
+		real = exp(-t * t / 2) * (-t * t + 1);
 		break;
 	case INV:
-		wcscat(name, L"(Inv).w");
+		real = t * exp(-t * t / 2);
 		break;
 	case MORL:
-		wcscat(name, L"(Morl).w");
+		real = exp(-t * t / 2) * (cs - sn);
 		break;
 	case MORLPOW:
-		wcscat(name, L"(MPow).w");
+		real = exp(-t * t / 2) * cs;
+		image = exp(-t * t / 2) * sn;
 		break;
 	case MORLFULL:
-		wcscat(name, L"(MComp");
-		swprintf(tmp, L"%d", (int)w);
-		wcscat(name, tmp);
-		wcscat(name, L").w");
+		real = exp(-t * t / 2) * (cs - exp(-w * w / 2));
+		image = exp(-t * t / 2) * (sn - exp(-w * w / 2));
 		break;
 
 	case GAUS:
-		wcscat(name, L"(Gaussian).w");
+		real = exp(-t * t / 2);
 		break;
 	case GAUS1:
-		wcscat(name, L"(1Gauss).w");
+		real = -t * exp(-t * t / 2);
 		break;
 	case GAUS2:
-		wcscat(name, L"(2Gauss).w");
+		real = (t * t - 1) * exp(-t * t / 2);
 		break;
 	case GAUS3:
-		wcscat(name, L"(3Gauss).w");
+		real = (2 * t + t - t * t * t) * exp(-t * t / 2);
 		break;
 	case GAUS4:
-		wcscat(name, L"(4Gauss).w");
+		real = (3 - 6 * t * t + t * t * t * t) * exp(-t * t / 2);
 		break;
 	case GAUS5:
-		wcscat(name, L"(5Gauss).w");
+		real = (-15 * t + 10 * t * t * t - t * t * t * t * t) * exp(-t * t / 2);
 		break;
 	case GAUS6:
-		wcscat(name, L"(6Gauss).w");
+		real = (-15 + 45 * t * t - 15 * t * t * t * t + t * t * t * t * t * t) * exp(-t * t / 2);
 		break;
 	case GAUS7:
-		wcscat(name, L"(7Gauss).w");
+		real = (105 * t - 105 * t * t * t + 21 * t * t * t * t * t - t * t * t * t * t * t * t) * exp(-t * t / 2);
 		break;
+	default:
+		real = 0;
 	}
+}
 
-	if (hdr->type)
-		filesize = hdr->size * (int)ceil((log(hdr->fmax) + hdr->fstep - log(hdr->fmin)) / hdr->fstep);
-	else
-		filesize = hdr->size * (int)ceil((hdr->fmax + hdr->fstep - hdr->fmin) / hdr->fstep);
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+std::shared_ptr<const typename ContinuousWaveletTransformT<T>::Kernel> ContinuousWaveletTransformT<T>::_makeKernel(double w, double scale,
+                                                                                                   int size)
+{
+	std::shared_ptr<Kernel> kernel = std::make_shared<Kernel>();
+	const bool complex = (W == MORLPOW || W == MORLFULL);
+	std::vector<double> real, image;
+	double re, im;
+	int precisionSize = 0;                                   //0,0000001 float prsision
+
+	kernel->complete = false;
+	for (int i = 0; i < size; i++) {                         //positive side
+		_waveletTap<W>(w, double(i) / scale, re, im);
+		real.push_back(re);
+		image.push_back(im);
+
+		if (fabs(re) < 0.0000001)
+			precisionSize++;
+
+		if (precisionSize > 15) {
+			precisionSize = i;
+			kernel->complete = true;
+			break;
+		}
+	}
+	if (kernel->complete == false)
+		precisionSize = size;
+	kernel->support = precisionSize;
+
+	//taps this small only add denormal products (slow on x86) to float sums
+	const double tiny = sqrt(double(std::numeric_limits<T>::min()));
+	const int center = precisionSize - 1;
+	kernel->real.resize(2 * precisionSize - 1);
+	if (complex)
+		kernel->image.resize(2 * precisionSize - 1);
+
+	for (int i = -(precisionSize - 1); i < precisionSize; i++) {   //negative side, then positive one
+		if (i < 0)
+			_waveletTap<W>(w, double(i) / scale, re, im);
+		else {
+			re = real[i];
+			im = image[i];
+		}
+		if (fabs(re) < tiny)
+			re = 0;
+		if (fabs(im) < tiny)
+			im = 0;
+		kernel->real[center + i] = T(re);
+		if (complex)
+			kernel->image[center + i] = T(im);
+	}
 
+	return kernel;
+}
 
-	filesize = sizeof(float) * filesize + sizeof(CWT_HEADER);
+// kernels depend only on wavelet, scale and sample rate, so are shared by all
+// transforms in the process. An incomplete kernel (precision not reached within
+// the signal size) is recomputed when a longer signal asks for it.
+template <typename T>
+std::shared_ptr<const typename ContinuousWaveletTransformT<T>::Kernel> ContinuousWaveletTransformT<T>::_getKernel(enum WAVELET wavelet,
+                                                                                                             double w, double scale,
+                                                                                                             double sr, int size)
+{
+	if (wavelet != MORLFULL)
+		w = 0;
+	const KernelKey key(wavelet, w, scale, sr);
+
+	{
+		std::lock_guard<std::mutex> lock(_kernelCacheMutex);
+		typename std::map<KernelKey, std::shared_ptr<const Kernel> >::const_iterator it = _kernelCache.find(key);
+		if (it != _kernelCache.end() && (it->second->complete || it->second->support >= size))
+			return it->second;
+	}
 
-	_fp = CreateFileW(name, GENERIC_WRITE | GENERIC_READ, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
-	if (_fp == INVALID_HANDLE_VALUE)
-		return 0;
-	_fpmap = CreateFileMapping(_fp, 0, PAGE_READWRITE, 0, filesize, 0);
-	_lpMap = MapViewOfFile(_fpmap, FILE_MAP_WRITE, 0, 0, filesize);
+	std::shared_ptr<const Kernel> kernel;
+	switch (wavelet) {
+	case MHAT: kernel = _makeKernel<MHAT>(w, scale, size); break;
+	case INV: kernel = _makeKernel<INV>(w, scale, size); break;
+	case MORL: kernel = _makeKernel<MORL>(w, scale, size); break;
+	case MORLPOW: kernel = _makeKernel<MORLPOW>(w, scale, size); break;
+	case MORLFULL: kernel = _makeKernel<MORLFULL>(w, scale, size); break;
+	case GAUS: kernel = _makeKernel<GAUS>(w, scale, size); break;
+	case GAUS1: kernel = _makeKernel<GAUS1>(w, scale, size); break;
+	case GAUS2: kernel = _makeKernel<GAUS2>(w, scale, size); break;
+	case GAUS3: kernel = _makeKernel<GAUS3>(w, scale, size); break;
+	case GAUS4: kernel = _makeKernel<GAUS4>(w, scale, size); break;
+	case GAUS5: kernel = _makeKernel<GAUS5>(w, scale, size); break;
+	case GAUS6: kernel = _makeKernel<GAUS6>(w, scale, size); break;
+	case GAUS7: kernel = _makeKernel<GAUS7>(w, scale, size); break;
+	default: kernel = _makeKernel<MHAT>(w, scale, size); break;
+	}
+
+	std::lock_guard<std::mutex> lock(_kernelCacheMutex);
+	if (_kernelCache.size() >= KERNEL_CACHE_SIZE)
+		_kernelCache.clear();
+	std::shared_ptr<const Kernel>& cached = _kernelCache[key];
+	if (!cached || (!cached->complete && cached->support < kernel->support))
+		cached = kernel;
+	return kernel;
+}
+
+template <typename T>
+void ContinuousWaveletTransformT<T>::ClearKernelCache()
+{
+	std::lock_guard<std::mutex> lock(_kernelCacheMutex);
+	_kernelCache.clear();
+}
+
+//////////////////////FFT convolution///////////////////////////////////////////////////////////
+// in-place radix-2 complex FFT, n power of 2, cs/sn twiddles of n/2 size
+template <typename T>
+static void fft(T *re, T *im, int n, const T *cs, const T *sn, bool inverse)
+{
+	for (int i = 1, j = 0; i < n; i++) {                       //bit reversal
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j) {
+			T tmp = re[i]; re[i] = re[j]; re[j] = tmp;
+			tmp = im[i]; im[i] = im[j]; im[j] = tmp;
+		}
+	}
+
+	for (int len = 2; len <= n; len <<= 1) {
+		const int half = len >> 1;
+		const int step = n / len;
+		for (int i = 0; i < n; i += len) {
+			for (int k = 0; k < half; k++) {
+				const T wr = cs[k * step];
+				const T wi = inverse ? sn[k * step] : -sn[k * step];
+				T *ur = re + i + k, *ui = im + i + k;
+				T *vr = re + i + k + half, *vi = im + i + k + half;
+				const T tr = *vr * wr - *vi * wi;
+				const T ti = *vr * wi + *vi * wr;
+				*vr = *ur - tr;
+				*vi = *ui - ti;
+				*ur += tr;
+				*ui += ti;
+			}
+		}
+	}
+}
+
+template <typename T>
+void ContinuousWaveletTransformT<T>::_fillBlock(T *block, int from, int count) const
+{
+	for (int m = 0; m < count; m++) {
+		const int j = from + m;
+
+		if (j < 0) {                                             // Left edge
+			if (_isPeriodicBoundary)
+				block[m] = _pData[-j];
+			else
+				block[m] = (_leftValue != 0.0) ? T(_leftValue) : _pData[0];
+		}
+		else if (j < _signalSize)
+			block[m] = _pData[j];
+		else if (j < _signalSize + _precisionSize - 1) {        // Right edge
+			if (_isPeriodicBoundary)
+				block[m] = _pData[2 * (_signalSize - 1) - j];
+			else
+				block[m] = (_rightValue != 0.0) ? T(_rightValue) : _pData[_signalSize - 1];
+		}
+		else
+			block[m] = 0.0;                                      //past the support, output discarded
+	}
+}
+
+// same sums as _transform() over [-(_precisionSize-1), _precisionSize-1] wavelet taps,
+// computed block-wise with overlap-save; two real blocks are packed into one complex FFT
+// for real wavelets, complex wavelets get Re/Im parts from a single block
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+void ContinuousWaveletTransformT<T>::_fftTransform(double scale)
+{
+	const bool complex = (W == MORLPOW || W == MORLFULL);
+	const int taps = 2 * _precisionSize - 1;
+
+	int n = 256;
+	while (n < 4 * taps && n < _signalSize + taps - 1)
+		n <<= 1;
+	const int block = n - (taps - 1);                           //valid outputs per FFT block
+
+	if (n > _fftCapacity) {                                     //[cs][sn][hRe][hIm][zRe][zIm]
+		if (_pFftBuffer) free(_pFftBuffer);
+		_pFftBuffer = static_cast<T *>(malloc(sizeof(T) * 5 * n));
+		_fftCapacity = n;
+		_fftSize = 0;
+	}
+	T *cs = _pFftBuffer;
+	T *sn = cs + n / 2;
+	T *hRe = sn + n / 2;
+	T *hIm = hRe + n;
+	T *zRe = hIm + n;
+	T *zIm = zRe + n;
+
+	if (_fftSize != n) {                                        //twiddles shared by all scales of this size
+		for (int k = 0; k < n / 2; k++) {
+			cs[k] = T(cos(2.0 * M_PI * k / n));
+			sn[k] = T(sin(2.0 * M_PI * k / n));
+		}
+		_pFftKernel.reset();
+	}
+	if (_pFftKernel != _pKernel || _fftTaps != taps) {
+		//time reversed wavelet
+		memset(hRe, 0, sizeof(T) * n);
+		memset(hIm, 0, sizeof(T) * n);
+		for (int k = 0; k < taps; k++) {
+			hRe[k] = _pReal[(taps - 1) - k];
+			if (complex)
+				hIm[k] = _pImage[(taps - 1) - k];
+		}
+		fft(hRe, hIm, n, cs, sn, false);
+
+		_fftSize = n;
+		_pFftKernel = _pKernel;
+		_fftTaps = taps;
+	}
+
+	for (int x = 0; x < _signalSize; ) {
+		const int x2 = complex ? _signalSize : x + block;       //second packed block
+
+		_fillBlock(zRe, x - (_precisionSize - 1), n);
+		if (x2 < _signalSize)
+			_fillBlock(zIm, x2 - (_precisionSize - 1), n);
+		else
+			memset(zIm, 0, sizeof(T) * n);
+
+		fft(zRe, zIm, n, cs, sn, false);
+		const T norm = T(1.0 / n);
+		for (int k = 0; k < n; k++) {
+			const T re = zRe[k] * hRe[k] - zIm[k] * hIm[k];
+			const T im = zRe[k] * hIm[k] + zIm[k] * hRe[k];
+			zRe[k] = re * norm;
+			zIm[k] = im * norm;
+		}
+		fft(zRe, zIm, n, cs, sn, true);
+
+		for (int u = 0; u < block && x + u < _signalSize; u++) {
+			if (complex)
+				_pSpectrum[x + u] = T(_spectrumValue<W>(zRe[u + taps - 1], zIm[u + taps - 1], scale));
+			else
+				_pSpectrum[x + u] = T(_spectrumValue<W>(zRe[u + taps - 1], 0, scale));
+		}
+		if (!complex) {
+			for (int u = 0; u < block && x2 + u < _signalSize; u++)
+				_pSpectrum[x2 + u] = T(_spectrumValue<W>(zIm[u + taps - 1], 0, scale));
+		}
+
+		x += complex ? block : 2 * block;
+	}
+
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
 
-	_lpf = (float *)_lpMap;
 
-	memset(_lpMap, 0, filesize);
-	memcpy(_lpMap, hdr, sizeof(CWT_HEADER));
+//////////////////////recursive gaussian////////////////////////////////////////////////////////
+// Deriche 4th order coefficients {a0, a1, b0, b1, c0, c1, w0, w1} for exp(-t*t/2) and its derivative
+static const double dericheGaussian[8] = { 1.68, 3.735, 1.783, 1.723, -0.6803, -0.2598, 0.6318, 1.997 };
+static const double dericheDerivative[8] = { -0.6472, -4.531, 1.527, 1.516, 0.6494, 0.9557, 0.6719, 2.072 };
 
-	return (_lpf + sizeof(CWT_HEADER) / sizeof(float));
+// causal n[4], anticausal m[4] and common d[4] recursion coefficients for sigma
+static void dericheCoefficients(const double *p, double sigma, bool symmetric, double *n, double *m, double *d)
+{
+	const double a0 = p[0], a1 = p[1], b0 = p[2], b1 = p[3], c0 = p[4], c1 = p[5], w0 = p[6], w1 = p[7];
+	const double e0 = exp(-b0 / sigma), e1 = exp(-b1 / sigma);
+	const double cs0 = cos(w0 / sigma), sn0 = sin(w0 / sigma);
+	const double cs1 = cos(w1 / sigma), sn1 = sin(w1 / sigma);
+
+	n[0] = a0 + c0;
+	n[1] = e1 * (c1 * sn1 - (c0 + 2 * a0) * cs1) + e0 * (a1 * sn0 - (2 * c0 + a0) * cs0);
+	n[2] = 2 * e0 * e1 * ((a0 + c0) * cs1 * cs0 - a1 * cs1 * sn0 - c1 * cs0 * sn1) + c0 * e0 * e0 + a0 * e1 * e1;
+	n[3] = e1 * e0 * e0 * (c1 * sn1 - c0 * cs1) + e0 * e1 * e1 * (a1 * sn0 - a0 * cs0);
+
+	d[0] = -2 * e1 * cs1 - 2 * e0 * cs0;
+	d[1] = 4 * cs1 * cs0 * e0 * e1 + e1 * e1 + e0 * e0;
+	d[2] = -2 * cs0 * e0 * e1 * e1 - 2 * cs1 * e1 * e0 * e0;
+	d[3] = e0 * e0 * e1 * e1;
+
+	const double sign = symmetric ? 1.0 : -1.0;
+	for (int i = 0; i < 3; i++)
+		m[i] = sign * (n[i + 1] - d[i] * n[0]);
+	m[3] = -sign * d[3] * n[0];
 }
 
-float* ContinuousWaveletTransform::CwtReadFile(const wchar_t *name)
+// y = causal + anticausal recursion over x[0..size)
+static void dericheFilter(const double *x, double *y, int size, const double *n, const double *m, const double *d)
 {
-	_fp = CreateFileW(name, GENERIC_WRITE | GENERIC_READ, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
-	if (_fp == INVALID_HANDLE_VALUE)
+	double x1 = 0, x2 = 0, x3 = 0, y1 = 0, y2 = 0, y3 = 0, y4 = 0;
+	for (int i = 0; i < size; i++) {
+		const double yn = n[0] * x[i] + n[1] * x1 + n[2] * x2 + n[3] * x3 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+		x3 = x2; x2 = x1; x1 = x[i];
+		y4 = y3; y3 = y2; y2 = y1; y1 = yn;
+		y[i] = yn;
+	}
+
+	double x4 = 0;
+	x1 = x2 = x3 = 0;
+	y1 = y2 = y3 = y4 = 0;
+	for (int i = size - 1; i >= 0; i--) {
+		const double yn = m[0] * x1 + m[1] * x2 + m[2] * x3 + m[3] * x4 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+		x4 = x3; x3 = x2; x2 = x1; x1 = x[i];
+		y4 = y3; y3 = y2; y2 = y1; y1 = yn;
+		y[i] += yn;
+	}
+}
+
+// the recursive filter is rescaled to the sum (GAUS) or first moment (GAUS1) of the exact
+// wavelet taps; the signal is padded past the wavelet support so the recursion settles
+// (decay exp(-1.5 n/scale)) before the boundary extension region is reached
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+void ContinuousWaveletTransformT<T>::_recursiveTransform(double scale)
+{
+	const bool symmetric = (W == GAUS);
+	double n[4], m[4], d[4];
+	dericheCoefficients(symmetric ? dericheGaussian : dericheDerivative, scale, symmetric, n, m, d);
+
+	const int center = _precisionSize - 1;
+	const int settle = int(12.0 * scale) + 4;
+
+	//normalization from the impulse response
+	std::vector<double> impulse(2 * settle + 1, 0.0), response(2 * settle + 1);
+	impulse[settle] = 1.0;
+	dericheFilter(&impulse[0], &response[0], 2 * settle + 1, n, m, d);
+
+	double exact = 0, approx = 0;
+	for (int k = -center; k <= center; k++)
+		exact += symmetric ? _pReal[center + k] : k * _pReal[center + k];
+	for (int k = -settle; k <= settle; k++)                     //wavelet tap k = response(-k)
+		approx += symmetric ? response[settle - k] : k * response[settle - k];
+	const double norm = exact / approx;
+
+	//padded edges [-pad, 0) and [size, size+pad), constant past the wavelet support
+	const int pad = center + settle;
+	if (2 * pad > _padCapacity) {
+		if (_pPadBuffer) free(_pPadBuffer);
+		_pPadBuffer = static_cast<T *>(malloc(sizeof(T) * 2 * pad));
+		_padCapacity = 2 * pad;
+	}
+	T *pLeft = _pPadBuffer;
+	T *pRight = _pPadBuffer + pad;
+	_fillBlock(pLeft + settle, -center, center);
+	_fillBlock(pRight, _signalSize, center);
+	for (int i = 0; i < settle; i++) {
+		pLeft[i] = (center > 0) ? pLeft[settle] : _pData[0];
+		pRight[center + i] = (center > 0) ? pRight[center - 1] : _pData[_signalSize - 1];
+	}
+
+	double x1 = 0, x2 = 0, x3 = 0, x4 = 0, y1 = 0, y2 = 0, y3 = 0, y4 = 0;
+	for (int i = -pad; i < _signalSize; i++) {                  //causal, state kept in double
+		const double xn = (i < 0) ? pLeft[i + pad] : _pData[i];
+		const double yn = n[0] * xn + n[1] * x1 + n[2] * x2 + n[3] * x3 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+		x3 = x2; x2 = x1; x1 = xn;
+		y4 = y3; y3 = y2; y2 = y1; y1 = yn;
+		if (i >= 0)
+			_pSpectrum[i] = T(yn);
+	}
+
+	x1 = x2 = x3 = 0;
+	y1 = y2 = y3 = y4 = 0;
+	for (int i = _signalSize + pad - 1; i >= 0; i--) {         //anticausal
+		const double yn = m[0] * x1 + m[1] * x2 + m[2] * x3 + m[3] * x4 - d[0] * y1 - d[1] * y2 - d[2] * y3 - d[3] * y4;
+		x4 = x3; x3 = x2; x2 = x1; x1 = (i < _signalSize) ? _pData[i] : pRight[i - _signalSize];
+		y4 = y3; y3 = y2; y2 = y1; y1 = yn;
+		if (i < _signalSize)
+			_pSpectrum[i] = T(_spectrumValue<W>(norm * (_pSpectrum[i] + yn), 0, scale));
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousWaveletTransformBase::GetFreqRange() const
+{
+	if (_frequencyInterval <= 0 || _minFrequency <= 0 || _maxFrequency < _minFrequency)
 		return 0;
-	_fpmap = CreateFileMapping(_fp, 0, PAGE_READWRITE, 0, 0, 0);
-	_lpMap = MapViewOfFile(_fpmap, FILE_MAP_WRITE, 0, 0, 0);
+	if (_scaleType == LINEAR_SCALE)
+		return int((_maxFrequency + _frequencyInterval - _minFrequency) / _frequencyInterval + FLOAT_EQ_ERR);
+	if (_scaleType == LOG_SCALE)
+		return int((log(_maxFrequency) + _frequencyInterval - log(_minFrequency)) / _frequencyInterval + FLOAT_EQ_ERR);
+	return 0;
+}
+
+double ContinuousWaveletTransformBase::GetMinFreq() const
+{
+	return _minFrequency;
+}
+
+double ContinuousWaveletTransformBase::GetMaxFreq() const
+{
+	return _maxFrequency;
+}
+
+double ContinuousWaveletTransformBase::GetFreqInterval() const
+{
+	return _frequencyInterval;
+}
+
+int ContinuousWaveletTransformBase::GetScaleType() const
+{
+	return _scaleType;
+}
+
+double ContinuousWaveletTransformBase::GetFrequency(int row) const
+{
+	if (_scaleType == LOG_SCALE)
+		return exp(log(_minFrequency) + row * _frequencyInterval);
+	return _minFrequency + row * _frequencyInterval;
+}
 
-	_pHDR = (CWT_HEADER)_lpMap;
-	_lpf = (float *)_lpMap;
+void ContinuousWaveletTransformBase::SetFreqRange(double minFreq, double maxFreq, double interval, enum SCALE_TYPE type)
+{
+	_minFrequency = minFreq;
+	_maxFrequency = maxFreq;
+	_frequencyInterval = interval;
+	_scaleType = type;
+}
 
+// rows are handed out one at a time, so the long low frequency wavelets spread over
+// the workers; each extra worker has its own workspace, kernels come from the shared cache
+template <typename T>
+int ContinuousWaveletTransformT<T>::TransformRange(const T *data, T *scalogram, bool periodicBoundary, double lv, double rv,
+                                                  int threads, enum CONVOLUTION convolution)
+{
+	const int size = _signalSize;
+	return TransformRange(data, [scalogram, size](int row, const T *spectrum) {
+		memcpy(scalogram + size_t(row) * size, spectrum, sizeof(T) * size);
+	}, periodicBoundary, lv, rv, threads, convolution);
+}
 
-	if (memcmp(_pHDR->hdr, "WLET", 4))
+template <typename T>
+int ContinuousWaveletTransformT<T>::TransformRange(const T *data, const std::function<void(int, const T *)> &rowSink,
+                                                  bool periodicBoundary, double lv, double rv, int threads, enum CONVOLUTION convolution)
+{
+	const int rows = GetFreqRange();
+	if (rows <= 0 || _signalSize <= 0)
 		return 0;
 
-	_minFreq = _pHDR->fmin;
-	_maxFreq = _pHDR->fmax;
-	_freqInterval = _pHDR->fstep;
-	_length = _pHDR->size;
-	_sr = _pHDR->sr;
-	if (_pHDR->type == LINEAR_SCALE)
-		_scaleType = LINEAR_SCALE;
-	else if (_pHDR->type == LOG_SCALE)
-		_scaleType = LOG_SCALE;
-
-	return (_lpf + sizeof(CWT_HEADER) / sizeof(float));
+	if (threads <= 0)
+		threads = int(std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, rows));
+
+	std::atomic<int> next(0);
+	auto worker = [&](ContinuousWaveletTransformT *cwt) {
+		for (int row = next++; row < rows; row = next++)
+			rowSink(row, cwt->Transform(data, GetFrequency(row), periodicBoundary, lv, rv, convolution));
+	};
+
+	std::vector<std::unique_ptr<ContinuousWaveletTransformT> > workers;
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++) {
+		workers.emplace_back(new ContinuousWaveletTransformT());
+		workers.back()->init(_signalSize, _wavelet, _w0, _sampleRate);
+		pool.emplace_back(worker, workers.back().get());
+	}
+	worker(this);
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+
+	return rows;
+}
+
+template <typename T>
+void ContinuousWaveletTransformT<T>::init(int size, enum WAVELET wavelet, double w, double sr)
+{
+	_signalSize = size;
+
+    if (sr > 0)
+		_sampleRate = sr;
+
+	_w0 = w;
+	if (_signalSize > _spectrumCapacity) {                //buffers kept at their high-water mark until close()
+		if (_pSpectrum) free(_pSpectrum);
+		_pSpectrum = static_cast<T *>(malloc(sizeof(T) * (_signalSize)));
+		_spectrumCapacity = _signalSize;
+	}
+	_wavelet = wavelet;
+}
+
+template <typename T>
+void  ContinuousWaveletTransformT<T>::close()
+{
+	_pKernel.reset();
+	_pReal = nullptr;
+	_pImage = nullptr;
+
+	if (_pSpectrum) {
+		free(_pSpectrum);
+		_pSpectrum = nullptr;
+	}
+	_spectrumCapacity = 0;
+
+	if (_pFftBuffer) {
+		free(_pFftBuffer);
+		_pFftBuffer = nullptr;
+	}
+	_pFftKernel.reset();
+	_fftCapacity = 0;
+	_fftSize = 0;
+
+	if (_pPadBuffer) {
+		free(_pPadBuffer);
+		_pPadBuffer = nullptr;
+	}
+	_padCapacity = 0;
 }
-*/
-double ContinuousWaveletTransform::HzToScale(double f, double sr, enum WAVELET wavelet, double w)
+
+double ContinuousWaveletTransformBase::HzToScale(double f, double sr, enum WAVELET wavelet, double w)
 {
 	double k;
 
@@ -329,7 +714,7 @@ double ContinuousWaveletTransform::HzToScale(double f, double sr, enum WAVELET w
 	return (k / f);
 }
 
-void ContinuousWaveletTransform::ConvertName(char *name, enum WAVELET wavelet, double w)
+void ContinuousWaveletTransformBase::ConvertName(char *name, enum WAVELET wavelet, double w)
 {
     char tmp[_MAX_PATH];
 
@@ -382,153 +767,106 @@ void ContinuousWaveletTransform::ConvertName(char *name, enum WAVELET wavelet, d
 }
 
 
-double* ContinuousWaveletTransform::Transform(const double* data, const double freq, const bool periodicBoundary, const double lValue,
-                                              const double rValue)
+template <typename T>
+template <ContinuousWaveletTransformBase::WAVELET W>
+void ContinuousWaveletTransformT<T>::_transformAll(double scale, enum CONVOLUTION convolution)
+{
+	if (convolution == RECURSIVE_CONVOLUTION) {
+		if ((W == GAUS || W == GAUS1) && _isPrecision) {
+			_recursiveTransform<W>(scale);
+			return;
+		}
+		convolution = AUTO_CONVOLUTION;
+	}
+	if (convolution == AUTO_CONVOLUTION)                     //FFT pays off on long wavelet support
+		convolution = (2 * _precisionSize - 1 >= FFT_MIN_TAPS) ? FFT_CONVOLUTION : DIRECT_CONVOLUTION;
+
+	if (convolution == FFT_CONVOLUTION) {
+		_fftTransform<W>(scale);
+		return;
+	}
+
+	//boundary extension is applied once to the edge regions [-center, left+center) and
+	//[right-center, size+center), then every output is the same dot product over a window
+	const int center = _precisionSize - 1;
+	const int left = (_signalSize < center) ? _signalSize : center;
+	const int right = (_signalSize - center > left) ? _signalSize - center : left;
+	const int leftCount = left + 2 * center;
+	const int rightCount = (_signalSize - right) + 2 * center;
+
+	if (leftCount + rightCount > _padCapacity) {
+		if (_pPadBuffer) free(_pPadBuffer);
+		_pPadBuffer = static_cast<T *>(malloc(sizeof(T) * (leftCount + rightCount)));
+		_padCapacity = leftCount + rightCount;
+	}
+	T *pLeft = _pPadBuffer;
+	T *pRight = _pPadBuffer + leftCount;
+
+	_fillBlock(pLeft, -center, leftCount);
+	_fillBlock(pRight, right - center, rightCount);
+
+	for (int x = 0; x < left; x++)                           // Left edge
+		_pSpectrum[x] = T(_transform<W>(pLeft + x, scale));
+	for (int x = left; x < right; x++)                       //main
+		_pSpectrum[x] = T(_transform<W>(_pData + x - center, scale));
+	for (int x = right; x < _signalSize; x++)                // Right edge
+		_pSpectrum[x] = T(_transform<W>(pRight + (x - right), scale));
+}
+
+template <typename T>
+T* ContinuousWaveletTransformT<T>::Transform(const T* data, const double freq, const bool periodicBoundary, const double lValue,
+                                             const double rValue, enum CONVOLUTION convolution)
 {
 	_isPeriodicBoundary = periodicBoundary;
 	_leftValue = lValue;
 	_rightValue = rValue;
 
-	_isPrecision = false;
-	_precisionSize = 0;                                      //0,0000001 float prsision
-	double t, sn = 0, cs = 0;
-
 	const double scale = HzToScale(freq, _sampleRate, _wavelet, _w0);
 
-	///////////wavelet calculation//////////////////////////////////////////////////////////////////
-	///////// center = SignalSize-1 in wavelet mass////////////////////////////////////////////////////
-
-	for (int i = 0; i < _signalSize; i++) {                     //positive side
-		t = double(i) / scale;
-
-		if (_wavelet > INV && _wavelet < MORLFULL) {
-			sn = sin(6.28 * t);
-			cs = cos(6.28 * t);
-		}
-		if (_wavelet == MORLFULL) {
-			sn = sin(_w0 * t);
-			cs = cos(_w0 * t);
-		}
-
-		switch (_wavelet) {
-		case MHAT:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (-t * t + 1);
-			break;
-		case INV:
-			_pReal[(_signalSize - 1) + i] = t * exp(-t * t / 2);
-			break;
-		case MORL:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (cs - sn);
-			break;
-		case MORLPOW:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * cs;
-			_pImage[(_signalSize - 1) + i] = exp(-t * t / 2) * sn;
-			break;
-		case MORLFULL:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (cs - exp(-_w0 * _w0 / 2));
-			_pImage[(_signalSize - 1) + i] = exp(-t * t / 2) * (sn - exp(-_w0 * _w0 / 2));
-			break;
-
-		case GAUS:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2);
-			break;
-		case GAUS1:
-			_pReal[(_signalSize - 1) + i] = -t * exp(-t * t / 2);
-			break;
-		case GAUS2:
-			_pReal[(_signalSize - 1) + i] = (t * t - 1) * exp(-t * t / 2);
-			break;
-		case GAUS3:
-			_pReal[(_signalSize - 1) + i] = (2 * t + t - t * t * t) * exp(-t * t / 2);
-			break;
-		case GAUS4:
-			_pReal[(_signalSize - 1) + i] = (3 - 6 * t * t + t * t * t * t) * exp(-t * t / 2);
-			break;
-		case GAUS5:
-			_pReal[(_signalSize - 1) + i] = (-15 * t + 10 * t * t * t - t * t * t * t * t) * exp(-t * t / 2);
-			break;
-		case GAUS6:
-			_pReal[(_signalSize - 1) + i] = (-15 + 45 * t * t - 15 * t * t * t * t + t * t * t * t * t * t) * exp(-t * t / 2);
-			break;
-		case GAUS7:
-			_pReal[(_signalSize - 1) + i] = (105 * t - 105 * t * t * t + 21 * t * t * t * t * t - t * t * t * t * t * t * t) * exp(-t * t / 2);
-			break;
-		}
-
-		if (fabs(_pReal[(_signalSize - 1) + i]) < 0.0000001)
-			_precisionSize++;
-
-		if (_precisionSize > 15) {
-			_precisionSize = i;
-			_isPrecision = true;
-			break;
-		}
+	///////////wavelet from the kernel cache, center = _precisionSize-1 in wavelet mass/////////////
+	_pKernel = _getKernel(_wavelet, _w0, scale, _sampleRate, _signalSize);
+	if (_pKernel->complete && _pKernel->support < _signalSize) {
+		_isPrecision = true;
+		_precisionSize = _pKernel->support;
 	}
-	if (_isPrecision == false)
+	else {
+		_isPrecision = false;
 		_precisionSize = _signalSize;
+	}
 
-	for (int i = -(_precisionSize - 1); i < 0; i++) {               //negative side
-		t = double(i) / scale;
-
-		if (_wavelet > INV && _wavelet < MORLFULL) {
-			sn = sin(6.28 * t);
-			cs = cos(6.28 * t);
-		}
-		if (_wavelet == MORLFULL) {
-			sn = sin(_w0 * t);
-			cs = cos(_w0 * t);
-		}
+	const int offset = _pKernel->support - _precisionSize;
+	_pReal = &_pKernel->real[offset];
+	_pImage = _pKernel->image.empty() ? nullptr : &_pKernel->image[offset];
+	/////////////////////////////////////////////////////////////////////////////////////////////////
 
-		switch (_wavelet) {
-		case MHAT:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (-t * t + 1);
-			break;
-		case INV:
-			_pReal[(_signalSize - 1) + i] = t * exp(-t * t / 2);
-			break;
-		case MORL:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (cs - sn);
-			break;
-		case MORLPOW:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * cs;
-			_pImage[(_signalSize - 1) + i] = exp(-t * t / 2) * sn;
-			break;
-		case MORLFULL:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2) * (cs - exp(-_w0 * _w0 / 2));
-			_pImage[(_signalSize - 1) + i] = exp(-t * t / 2) * (sn - exp(-_w0 * _w0 / 2));
-			break;
+	_pData = data;
 
-		case GAUS:
-			_pReal[(_signalSize - 1) + i] = exp(-t * t / 2);    //gauss
-			break;
-		case GAUS1:
-			_pReal[(_signalSize - 1) + i] = -t * exp(-t * t / 2);   //gauss1
-			break;
-		case GAUS2:
-			_pReal[(_signalSize - 1) + i] = (t * t - 1) * exp(-t * t / 2);     //gauss2
-			break;
-		case GAUS3:
-			_pReal[(_signalSize - 1) + i] = (2 * t + t - t * t * t) * exp(-t * t / 2);    //gauss3
-			break;
-		case GAUS4:
-			_pReal[(_signalSize - 1) + i] = (3 - 6 * t * t + t * t * t * t) * exp(-t * t / 2);    //gauss4
-			break;
-		case GAUS5:
-			_pReal[(_signalSize - 1) + i] = (-15 * t + 10 * t * t * t - t * t * t * t * t) * exp(-t * t / 2);    //gauss5
-			break;
-		case GAUS6:
-			_pReal[(_signalSize - 1) + i] = (-15 + 45 * t * t - 15 * t * t * t * t + t * t * t * t * t * t) * exp(-t * t / 2);   //gauss6
-			break;
-		case GAUS7:
-			_pReal[(_signalSize - 1) + i] = (105 * t - 105 * t * t * t + 21 * t * t * t * t * t - t * t * t * t * t * t * t) * exp(-t * t / 2);    //gauss7
-			break;
-		}
+	switch (_wavelet) {                                      //specialised transform per wavelet
+	case MHAT: _transformAll<MHAT>(scale, convolution); break;
+	case INV: _transformAll<INV>(scale, convolution); break;
+	case MORL: _transformAll<MORL>(scale, convolution); break;
+	case MORLPOW: _transformAll<MORLPOW>(scale, convolution); break;
+	case MORLFULL: _transformAll<MORLFULL>(scale, convolution); break;
+	case GAUS: _transformAll<GAUS>(scale, convolution); break;
+	case GAUS1: _transformAll<GAUS1>(scale, convolution); break;
+	case GAUS2: _transformAll<GAUS2>(scale, convolution); break;
+	case GAUS3: _transformAll<GAUS3>(scale, convolution); break;
+	case GAUS4: _transformAll<GAUS4>(scale, convolution); break;
+	case GAUS5: _transformAll<GAUS5>(scale, convolution); break;
+	case GAUS6: _transformAll<GAUS6>(scale, convolution); break;
+	case GAUS7: _transformAll<GAUS7>(scale, convolution); break;
 	}
-	///////end wavelet calculations////////////////////////////////////////////
-
-	_pData = data;
-	for (int x = 0; x < _signalSize; x++)
-		_pSpectrum[x] = _transform(x, scale);
 
 	return _pSpectrum;
 }
+
+template <typename T>
+int ContinuousWaveletTransformT<T>::GetPrecisionSize(double freq) const
+{
+	const double scale = HzToScale(freq, _sampleRate, _wavelet, _w0);
+	std::shared_ptr<const Kernel> kernel = _getKernel(_wavelet, _w0, scale, _sampleRate, _signalSize);
+	return (kernel->complete && kernel->support < _signalSize) ? kernel->support : _signalSize;
+}
+
+template class ContinuousWaveletTransformT<double>;
+template class ContinuousWaveletTransformT<float>;
@@ -1,28 +1,32 @@
 #pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
 #include "ecgtypes.h"
 
-class ContinuousWaveletTransform
+//wavelets, frequency grid and scale conversion shared by the double and float transforms
+class ContinuousWaveletTransformBase
 {
 public:
-	ContinuousWaveletTransform();
-	~ContinuousWaveletTransform();
-
 	// Data
 	enum WAVELET { MHAT, INV, MORL, MORLPOW, MORLFULL, GAUS, GAUS1, GAUS2, GAUS3, GAUS4, GAUS5, GAUS6, GAUS7 };
 	enum SCALE_TYPE { LINEAR_SCALE, LOG_SCALE };
+	enum CONVOLUTION { AUTO_CONVOLUTION, DIRECT_CONVOLUTION, FFT_CONVOLUTION, RECURSIVE_CONVOLUTION };
 
-	// Operators
-			//const CWT& operator=(const CWT& cwt);
+	//RECURSIVE_CONVOLUTION: GAUS and GAUS1 only, Deriche 4th order recursive filter with cost
+	//independent of scale. Wavelet error sum|psi'-psi|/sum|psi| is below 6e-4 for GAUS and 5.5e-3
+	//for GAUS1 (scale >= 2 samples), so |spectrum error| <= err * sum|psi| * max|data| / sqrt(scale).
+	//Other wavelets and signals shorter than the wavelet support fall back to AUTO_CONVOLUTION.
 
 	// Operations
-	//float* CwtCreateFileHeader(wchar_t *name, PCWT_HEADER hdr, enum WAVELET wavelet, double w);
-	//float* CwtReadFile(const wchar_t *name);
+	//scalogram files ("WLET", CWT_HEADER) are written and read by ScalogramFile
 	static double HzToScale(double f, double sr, enum WAVELET wavelet, double w);
     static void ConvertName(char *name, enum WAVELET wavelet, double w);
 
-	void init(int size, enum WAVELET wavelet, double w, double sr);
-	void close();
-	double* Transform(const double *data, double freq, bool periodicBoundary = true, double lv = 0, double rv = 0);
+	void SetFreqRange(double minFreq, double maxFreq, double interval, enum SCALE_TYPE type);
 
 	// Access
 	double GetMinFreq() const;
@@ -30,30 +34,100 @@ public:
 	double GetFreqInterval() const;
 	int GetScaleType() const;
 	int GetFreqRange() const;
+	double GetFrequency(int row) const;              //frequency of scalogram row
+
+protected:
+	ContinuousWaveletTransformBase();
+
+	double _minFrequency;
+	double _maxFrequency;
+	double _frequencyInterval;
+
+	enum SCALE_TYPE _scaleType;
+};
+
+//T = double, or float for half the memory traffic and twice the SIMD width: kernels, FFT and
+//spectra are kept in T, the recursive filter state and spectrum scaling stay in double.
+//float spectra are within 1e-6 of the spectrum peak of the double ones (record n26c, all wavelets),
+//three orders below one ADC step of a 12 bit record
+template <typename T>
+class ContinuousWaveletTransformT : public ContinuousWaveletTransformBase
+{
+public:
+	ContinuousWaveletTransformT();
+	~ContinuousWaveletTransformT();
+
+	// Operators
+			//const CWT& operator=(const CWT& cwt);
+
+	// Operations
+	static void ClearKernelCache();                  //drop all cached wavelet kernels of this sample type
+
+	void init(int size, enum WAVELET wavelet, double w, double sr);
+	void close();
+	T* Transform(const T *data, double freq, bool periodicBoundary = true, double lv = 0, double rv = 0,
+	             enum CONVOLUTION convolution = AUTO_CONVOLUTION);
+	//scalogram over the SetFreqRange() grid: GetFreqRange() rows of size samples, row i at GetFrequency(i)
+	//stored at scalogram[i * size]; threads 0 = all cores. returns rows written
+	int TransformRange(const T *data, T *scalogram, bool periodicBoundary = true, double lv = 0, double rv = 0,
+	                   int threads = 0, enum CONVOLUTION convolution = AUTO_CONVOLUTION);
+	//same rows handed to rowSink(row, spectrum) as they are computed, called from the worker threads
+	int TransformRange(const T *data, const std::function<void(int, const T *)> &rowSink, bool periodicBoundary = true,
+	                   double lv = 0, double rv = 0, int threads = 0, enum CONVOLUTION convolution = AUTO_CONVOLUTION);
 
 	// Inquiry
+	//wavelet taps [-(size-1), size-1] Transform() uses at freq: an output sample depends on the size-1
+	//samples on either side of it. The signal size if the kernel does not reach its precision within it
+	int GetPrecisionSize(double freq) const;
 
 private:
-	ContinuousWaveletTransform(const ContinuousWaveletTransform& cwt) = delete;
-	const ContinuousWaveletTransform& operator=(const ContinuousWaveletTransform& cwt) = delete;
-
-	double _transform(int x, double scale) const;
+	ContinuousWaveletTransformT(const ContinuousWaveletTransformT& cwt) = delete;
+	const ContinuousWaveletTransformT& operator=(const ContinuousWaveletTransformT& cwt) = delete;
+
+	//transform core, specialised per wavelet so the kernel formula is inlined
+	//and the imaginary part is only computed for complex wavelets
+	template <enum WAVELET W> void _transformAll(double scale, enum CONVOLUTION convolution);
+	template <enum WAVELET W> double _transform(const T *window, double scale) const;
+	template <enum WAVELET W> void _fftTransform(double scale);              //overlap-save convolution
+	template <enum WAVELET W> void _recursiveTransform(double scale);        //Deriche GAUS, GAUS1
+	template <enum WAVELET W> static double _spectrumValue(double real, double image, double scale);
+	void _fillBlock(T *block, int from, int count) const;                    //signal with boundary extension
+
+	struct Kernel {                               //wavelet taps, center = support-1 in wavelet mass
+		std::vector<T> real;
+		std::vector<T> image;                     //empty for real wavelets
+		int support;                              //precision size, or taps computed if not complete
+		bool complete;                            //0,0000001 precision reached
+	};
+	typedef std::tuple<int, double, double, double> KernelKey;    //wavelet, w0, scale, sample rate
+
+	static std::shared_ptr<const Kernel> _getKernel(enum WAVELET wavelet, double w, double scale, double sr, int size);
+	template <enum WAVELET W> static std::shared_ptr<const Kernel> _makeKernel(double w, double scale, int size);
+	template <enum WAVELET W> static void _waveletTap(double w, double t, double &real, double &image);
+
+	static std::map<KernelKey, std::shared_ptr<const Kernel> > _kernelCache;
+	static std::mutex _kernelCacheMutex;
 
 	PCWT_HEADER _pHDR;
 
-	double _minFrequency;
-	double _maxFrequency;
-	double _frequencyInterval;
 	double _w0;
-
-	enum SCALE_TYPE _scaleType;
 	enum WAVELET _wavelet;                   //Wavelet
 
 	int _signalSize;
-	const double *_pData;               //pointer to original signal
-	double *_pSpectrum;              //buffer with spectra
-	double *_pReal;
-	double *_pImage;
+	const T *_pData;                    //pointer to original signal
+	T *_pSpectrum;                   //buffer with spectra
+	int _spectrumCapacity;
+	std::shared_ptr<const Kernel> _pKernel;     //cached kernel in use
+	const T *_pReal;                 //wavelet taps [-(_precisionSize-1), _precisionSize-1]
+	const T *_pImage;
+
+	T *_pFftBuffer;                  //FFT workspace: twiddles, kernel spectrum, data blocks
+	int _fftCapacity;
+	int _fftSize;                                //FFT size, kernel and taps of the
+	std::shared_ptr<const Kernel> _pFftKernel;   //spectrum held in _pFftBuffer
+	int _fftTaps;
+	T *_pPadBuffer;                  //boundary extended left and right edges of the signal
+	int _padCapacity;
 
 	bool _isPrecision;
 	int _precisionSize;
@@ -65,6 +139,9 @@ private:
 
 };
 
+typedef ContinuousWaveletTransformT<double> ContinuousWaveletTransform;
+typedef ContinuousWaveletTransformT<float> ContinuousWaveletTransformF;
+
 /*//////////////////////////////////////////////
 		CWT *cwt;
 		cwt->InitCWT(size, CWT::MHAT, w0, SR);
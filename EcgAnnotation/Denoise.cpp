@@ -1,19 +1,24 @@
 #include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "Denoise.h"
 #include "helper.h"
+#include "signal.h"
 
 Denoise::Denoise()
 	: _pData(nullptr)
-	, _pBuffer(nullptr)
 	, _bufferSize(0)
+	, _pad(0)
+	, _extension(MIRROR_EXTENSION)
 	, _sampleRate(0)
 	, _length(0)
+	, _stationaryThreads(0)
 {
 }
 
 Denoise::~Denoise()
 {
-	delete[] _pBuffer;
 }
 
 void Denoise::init(double* data, int size, double sampleRate, bool mirror)
@@ -21,43 +26,96 @@ void Denoise::init(double* data, int size, double sampleRate, bool mirror)
 	_pData = data;
 	_sampleRate = sampleRate;
 	_length = size;
-	if (_pBuffer) delete[] _pBuffer;
-	_bufferSize = int(_length + 2 * _sampleRate);
-	_pBuffer = new double[_bufferSize];  // [SR add] [sig] [SR add]
-
-	for (int i = 0; i < _length; i++)           //signal
-		_pBuffer[i + int(_sampleRate)] = _pData[i];
+	_pad = int(_sampleRate);                   // [SR add] [sig] [SR add], added by the transforms
+	_bufferSize = _length + 2 * _pad;
 
 	if (_length < _sampleRate) mirror = false;
-
-	if (mirror) { //mirror extension of signal
-		for (int i = 0; i < int(_sampleRate); i++)          //left side
-			_pBuffer[i] = _pData[int(_sampleRate) - i];
-		for (int i = int(_length + _sampleRate); i < _bufferSize; i++)         //right side
-			_pBuffer[i] = _pData[(_length - 2) - (i - (_length + int(_sampleRate)))];
-	}
-	else {
-		for (int i = 0; i < int(_sampleRate); i++)          //left side
-			_pBuffer[i] = _pData[0];
-		for (int i = int(_length + _sampleRate); i < _bufferSize; i++)         //right side
-			_pBuffer[i] = _pData[_length - 1];
-	}
+	_extension = mirror ? MIRROR_EXTENSION : CONSTANT_EXTENSION;
 }
 
 void Denoise::close()
 {
-	if (_pBuffer) {
-		delete[] _pBuffer;
-		_pBuffer = nullptr;
-	}
+	FastWaveletTransform::close();
+	_stationary.close();
+}
+
+int Denoise::DenoiseLeads(class Signal *signal, enum PASS pass, enum TRANSFORM mode, int threads, bool mirror)
+{
+	const int leads = signal->GetLeadsNum();
+	if (threads <= 0)
+		threads = int(std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, leads));
+
+	std::atomic<int> next(0);
+	std::atomic<int> denoised(0);
+	auto worker = [&]() {
+		Denoise denoise;                              //workspace reused by the leads of this worker
+		denoise._stationaryThreads = threads > 1 ? 1 : 0;
+		for (int lead = next++; lead < leads; lead = next++) {
+			denoise.init(signal->GetData(lead), signal->GetLength(lead), signal->GetSR(lead), mirror);
+
+			bool ok = false;
+			switch (pass) {
+			case LF_PASS:
+				ok = denoise.LFDenoise(mode);
+				break;
+			case HF_PASS:
+				ok = denoise.HFDenoise(mode);
+				break;
+			case LFHF_PASS:
+				ok = denoise.LFHFDenoise(mode);
+				break;
+			case FUSED_LFHF_PASS:
+				ok = denoise.FusedLFHFDenoise(mode);
+				break;
+			}
+			if (ok) denoised++;
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+
+	return denoised;
+}
+
+//padded signal or, for a second pass, a result of _bufferSize samples
+bool Denoise::_init(const char* filter, const double* padded)
+{
+	if (padded)
+		return FastWaveletTransform::init(padded, _bufferSize, filter);
+	return FastWaveletTransform::init(_pData, _length, _pad, _extension, filter);
 }
 
-bool  Denoise::LFDenoise()
+bool Denoise::_stationaryInit(const char* filter, const double* padded)
 {
+	if (padded)
+		return _stationary.init(padded, _bufferSize, filter);
+	return _stationary.init(_pData, _length, _pad, _extension, filter);
+}
+
+bool  Denoise::LFDenoise(enum TRANSFORM mode)
+{
+	if (mode == STATIONARY) {
+		if (_stationaryLF(nullptr) == false)
+			return false;
+
+		const double *lo = _stationary.GetApproximation();
+		for (int i = 0; i < _length; i++)
+			_pData[i] = lo[i + _pad];
+
+		return true;
+	}
+
+
 	//get base line J///////
 	const int J =int(ceil(log2(_sampleRate / 0.8)) - 1);
 
-	if (FastWaveletTransform::init(_pBuffer, _bufferSize, "daub2.flt") == false)
+	if (_init("daub2.flt", nullptr) == false)
 		return false;
 
 
@@ -77,19 +135,29 @@ bool  Denoise::LFDenoise()
 	////////////////////////////////////
 
 	for (int i = 0; i < _length; i++)
-		_pData[i] = lo[i + int(_sampleRate)];
-
+		_pData[i] = lo[i + _pad];
 
-	close();
 	return true;
 }
 
-bool Denoise::HFDenoise()
+bool Denoise::HFDenoise(enum TRANSFORM mode)
 {
+	if (mode == STATIONARY) {
+		if (_stationaryHF(nullptr) == false)
+			return false;
+
+		const double *lo = _stationary.GetApproximation();
+		for (int i = 0; i < _length; i++)
+			_pData[i] = lo[i + _pad];
+
+		return true;
+	}
+
+
 	//get HF scale J///////
 	const int J =int(ceil(log2(_sampleRate / 23.0)) - 2);     //[30Hz - ...] hf denoising
 
-	if (FastWaveletTransform::init(_pBuffer, _bufferSize, "bior97.flt") == false)
+	if (_init("bior97.flt", nullptr) == false)
 		return false;
 
 
@@ -119,19 +187,38 @@ bool Denoise::HFDenoise()
 	////////////////////////////////////
 
 	for (int i = 0; i < _length; i++)
-		_pData[i] = lo[i + int(_sampleRate)];
-
+		_pData[i] = lo[i + _pad];
 
-	close();
 	return true;
 }
 
-bool Denoise::LFHFDenoise()
+bool Denoise::LFHFDenoise(enum TRANSFORM mode)
 {
+	if (mode == STATIONARY) {
+		if (_stationaryLF(nullptr) == false)
+			return false;
+
+		_pass.assign(_stationary.GetApproximation(), _stationary.GetApproximation() + _bufferSize);
+		double min, max;
+		MinMax(&_pass[_pad], _length, min, max);
+
+		if (_stationaryHF(_pass.data()) == false)
+			return false;
+
+		const double *lo = _stationary.GetApproximation();
+		for (int i = 0; i < _length; i++)
+			_pData[i] = lo[i + _pad];
+
+		NormalizeByMinMax(_pData, _length, min, max);
+
+		return true;
+	}
+
+
 	//get base line J///////
 	int J = int(ceil(log2(_sampleRate / 0.8)) - 1);
 
-	if (FastWaveletTransform::init(_pBuffer, _bufferSize, "daub2.flt") == false)
+	if (_init("daub2.flt", nullptr) == false)
 		return false;
 
 
@@ -148,21 +235,18 @@ bool Denoise::LFHFDenoise()
 	synthesis(J);
 	////////////////////////////////////
 
-	for (int i = 0; i < _bufferSize; i++)
-		_pBuffer[i] = lo[i];
+	_pass.assign(lo, lo + _bufferSize);
 
 	////////get min max///////////////////
 	double min, max;
-	MinMax(&lo[int(_sampleRate)], _length, min, max);
-
-	close();
+	MinMax(&_pass[_pad], _length, min, max);
 
 
 
 	//get HF scale J///////
 	J =int(ceil(log2(_sampleRate / 23.0)) - 2);     //[30Hz - ...] hf denoising
 
-	if (FastWaveletTransform::init(_pBuffer, _bufferSize, "bior97.flt") == false)
+	if (_init("bior97.flt", _pass.data()) == false)
 		return false;
 
 
@@ -189,11 +273,113 @@ bool Denoise::LFHFDenoise()
 	////////////////////////////////////
 
 	for (int i = 0; i < _length; i++)
-		_pData[i] = lo[i + int(_sampleRate)];
+		_pData[i] = lo[i + _pad];
 
 	//renormalize
 	NormalizeByMinMax(_pData, _length, min, max);
 
-	close();
+	return true;
+}
+
+bool Denoise::FusedLFHFDenoise(enum TRANSFORM mode)
+{
+	//get base line J and HF scale///////
+	const int J = int(ceil(log2(_sampleRate / 0.8)) - 1);
+	const int hfJ = int(ceil(log2(_sampleRate / 23.0)) - 2);     //[30Hz - ...] hf denoising
+
+	if (mode == STATIONARY) {
+		if (_stationaryInit("bior97.flt", nullptr) == false)
+			return false;
+
+		_stationary.transform(J, _stationaryThreads);
+
+		const int margin = _stationary.getMargin();
+		double *lo = _stationary.GetApproximation() - margin;
+		for (int i = 0; i < _bufferSize + 2 * margin; i++)
+			lo[i] = 0.0;
+		for (int j = hfJ; j > 0; j--)
+			denoise(_stationary.GetDetail(j) - margin, _bufferSize + 2 * margin, int(3.0 * _sampleRate));
+
+		_stationary.synthesis(J, _stationaryThreads);
+
+		lo = _stationary.GetApproximation();
+		for (int i = 0; i < _length; i++)
+			_pData[i] = lo[i + _pad];
+
+		return true;
+	}
+
+	if (_init("bior97.flt", nullptr) == false)
+		return false;
+
+
+	//transform////////////////////////
+	transform(J);
+	///////////////////////////////////
+
+	int *jNumbers = GetJNumbers(J, _bufferSize);
+	int hiNum;
+	int loNum;
+	hiLoNumbers(J, _bufferSize, hiNum, loNum);
+	double *lo = GetFwtSpectrum();
+	double *hi = GetFwtSpectrum() + (_bufferSize - hiNum);
+
+	for (int i = 0; i < loNum; i++)
+		lo[i] = 0.0;
+
+	for (int j = J; j > 0; j--) {
+		if (j <= hfJ) {
+			const int window = int(3.0 * _sampleRate / pow(2.0, double(j)));
+			denoise(hi, jNumbers[J - j], window);
+		}
+		hi += jNumbers[J - j];
+	}
+
+	//synth/////////////////////////////
+	synthesis(J);
+	////////////////////////////////////
+
+	for (int i = 0; i < _length; i++)
+		_pData[i] = lo[i + _pad];
+
+	return true;
+}
+
+//same scales and filters as the decimated path; bands carry getMargin() extra samples at both ends
+//which are zeroed and thresholded with the rest so the synthesis stays exact up to the edges.
+//The result is left in the approximation of _stationary
+bool Denoise::_stationaryLF(const double* padded)
+{
+	const int J = int(ceil(log2(_sampleRate / 0.8)) - 1);
+
+	if (_stationaryInit("daub2.flt", padded) == false)
+		return false;
+
+	_stationary.transform(J, _stationaryThreads);
+
+	const int margin = _stationary.getMargin();
+	double *lo = _stationary.GetApproximation() - margin;
+	for (int i = 0; i < _bufferSize + 2 * margin; i++)
+		lo[i] = 0.0;
+
+	_stationary.synthesis(J, _stationaryThreads);
+	return true;
+}
+
+bool Denoise::_stationaryHF(const double* padded)
+{
+	const int J = int(ceil(log2(_sampleRate / 23.0)) - 2);     //[30Hz - ...] hf denoising
+
+	if (_stationaryInit("bior97.flt", padded) == false)
+		return false;
+
+	_stationary.transform(J, _stationaryThreads);
+
+	const int margin = _stationary.getMargin();
+	const int window = int(3.0 * _sampleRate);                 //undecimated bands: same 3 s at every level
+	for (int j = J; j > 0; j--)
+		denoise(_stationary.GetDetail(j) - margin, _bufferSize + 2 * margin, window);
+
+	_stationary.synthesis(J, _stationaryThreads);
 	return true;
 }
@@ -1,5 +1,7 @@
 #pragma once
+#include <vector>
 #include "FastWaveletTransform.h"
+#include "StationaryWaveletTransform.h"
 
 class Denoise : public FastWaveletTransform
 {
@@ -7,16 +9,33 @@ public:
 	Denoise();
 	~Denoise();
 
+	// Data
+	//DECIMATED: FastWaveletTransform, STATIONARY: shift invariant StationaryWaveletTransform, the
+	//same output for a sample wherever the record is cut into chunks, at (J + 1) times the memory
+	enum TRANSFORM { DECIMATED, STATIONARY };
+	enum PASS { LF_PASS, HF_PASS, LFHF_PASS, FUSED_LFHF_PASS };
+
 	// Operators
 			//const EcgDenoise& operator=(const EcgDenoise& ecgdenoise);
 
 	// Operations
+	//transform buffers are kept between records at their high-water mark, close() frees them
     void init(double* data, int size, double sampleRate, bool mirror = true);
 	void close();
 
-	bool LFDenoise();         //baseline wander removal
-	bool HFDenoise();         //hf denoising
-	bool LFHFDenoise();       //baseline and hf denoising
+	bool LFDenoise(enum TRANSFORM mode = DECIMATED);         //baseline wander removal
+	bool HFDenoise(enum TRANSFORM mode = DECIMATED);         //hf denoising
+	bool LFHFDenoise(enum TRANSFORM mode = DECIMATED);       //baseline and hf denoising
+	//both in one bior97 decomposition to the baseline scale: the approximation is zeroed and the
+	//hf scales thresholded before a single synthesis. Unlike LFHFDenoise the output is not
+	//renormalized to the range of the baseline free signal, which is never synthesized
+	bool FusedLFHFDenoise(enum TRANSFORM mode = DECIMATED);
+
+	//pass over all leads of signal in place, leads shared by threads workers (0 = all cores) with a
+	//Denoise workspace each; stationary transforms run single threaded inside the workers.
+	//returns leads denoised
+	static int DenoiseLeads(class Signal *signal, enum PASS pass, enum TRANSFORM mode = DECIMATED, int threads = 0,
+	                        bool mirror = true);
 
 // Access
 // Inquiry
@@ -25,11 +44,22 @@ private:
 	Denoise(const Denoise& denoise) = delete;
 	const Denoise& operator=(const Denoise& denoise) = delete;
 
+	//transform of the padded signal (padded = nullptr) or of _bufferSize samples of a previous pass
+	bool _init(const char* filter, const double* padded);
+	bool _stationaryInit(const char* filter, const double* padded);
+	bool _stationaryLF(const double* padded);      //baseline removal
+	bool _stationaryHF(const double* padded);      //hf denoising
+
 	double* _pData;            //pointer to [original sig]
-	double* _pBuffer;           //[SRadd][original sig][SRadd]
-	int _bufferSize;
+	int _bufferSize;           //[SRadd][original sig][SRadd] as transformed
+	int _pad;
+	enum EXTENSION _extension;
 	double _sampleRate;
 	int _length;
 
+	StationaryWaveletTransform _stationary;
+	std::vector<double> _pass;     //padded result of the baseline pass of LFHFDenoise
+	int _stationaryThreads;        //threads of _stationary, 0 = all cores
+
 };
 
@@ -1,52 +1,185 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "FastWaveletTransform.h"
+#include "vectorops.h"
+#include "waveletfilters.h"
 
-std::string FastWaveletTransform::_filterDir = "filters/";
+#define POLYPHASE_BLOCK 256               //outputs per tap pass, block accumulators stay in L1
 
-FastWaveletTransform::FastWaveletTransform() : _pHDR(nullptr), _tH(nullptr), _tG(nullptr), _h(nullptr), _g(nullptr),
+std::string FastWaveletTransformBase::_filterDir;
+
+//////////////////////filters///////////////////////////////////////////////////////////////////
+struct FilterFile {                          //filter bank read from _filterDir
+	std::string name;
+	std::vector<double> taps;
+	WAVELET_FILTER filter;
+};
+
+static std::map<std::string, std::unique_ptr<const FilterFile> > filterFiles;   //by path, nullptr: no file
+static std::mutex filterFilesMutex;
+
+//"L Z" and L taps for tH, tG, h and g
+static std::unique_ptr<const FilterFile> readFilterFile(const std::string &path, const char *filterName)
+{
+	FILE *fp;
+	fopen_s(&fp, path.c_str(), "rt");
+	if (!fp)
+		return nullptr;
+
+	std::unique_ptr<FilterFile> file(new FilterFile);
+	file->name = filterName;
+	bool valid = true;
+	for (int f = 0; f < 4 && valid; f++) {
+		int L, Z;
+		valid = fscanf(fp, "%d %d", &L, &Z) == 2 && L > 0 && Z >= 0 && Z < L;
+		for (int i = 0; i < L && valid; i++) {
+			double tap;
+			valid = fscanf(fp, "%lf", &tap) == 1;
+			file->taps.push_back(tap);
+		}
+		file->filter.length[f] = L;
+		file->filter.center[f] = Z;
+	}
+	fclose(fp);
+	if (!valid)
+		return nullptr;
+
+	file->filter.name = file->name.c_str();
+	file->filter.taps = file->taps.data();
+	return file;
+}
+
+static bool sameFilter(const WAVELET_FILTER &filter, const WAVELET_FILTER *builtIn)
+{
+	if (!builtIn || memcmp(filter.length, builtIn->length, sizeof(filter.length)) ||
+	    memcmp(filter.center, builtIn->center, sizeof(filter.center)))
+		return false;
+
+	const int taps = filter.length[0] + filter.length[1] + filter.length[2] + filter.length[3];
+	return std::equal(filter.taps, filter.taps + taps, builtIn->taps);
+}
+
+//the file in _filterDir if there is a valid one, read once per path, otherwise the built-in filter
+const WAVELET_FILTER* FastWaveletTransformBase::_findFilter(const char *filterName, bool &builtIn)
+{
+	if (!_filterDir.empty()) {
+		const std::string path = _filterDir + filterName;
+		std::lock_guard<std::mutex> lock(filterFilesMutex);
+		auto file = filterFiles.find(path);
+		if (file == filterFiles.end()) {
+			std::unique_ptr<const FilterFile> read = readFilterFile(path, filterName);
+			if (read && sameFilter(read->filter, FindWaveletFilter(filterName)))
+				read.reset();                    //copy of the built-in filter, keeps its lifting scheme
+			file = filterFiles.emplace(path, std::move(read)).first;
+		}
+		if (file->second) {
+			builtIn = false;
+			return &file->second->filter;
+		}
+	}
+
+	builtIn = true;
+	return FindWaveletFilter(filterName);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+FastWaveletTransformT<T>::FastWaveletTransformT() : _pHDR(nullptr), _tH(nullptr), _tG(nullptr), _h(nullptr), _g(nullptr),
+_pTaps(nullptr), _tapCapacity(0),
 _thL(0), _tgL(0), _hL(0), _gL(0), _thZ(0), _tgZ(0), _hZ(0), _gZ(0),
-_j(0), _jNumbers(nullptr), _signalSize(0), _loBandSize(0),
-_pSpectrum(nullptr), _pTmpSpectrum(nullptr), _pHiData(nullptr), _pLoData(nullptr), _hiNum(0), _loNum(0)
+_pAnalysisLifting(nullptr), _pSynthesisLifting(nullptr), _liftMargin(0), _convMargin(0), _pChannels(nullptr),
+_channelCapacity(0), _pFilter(nullptr), _lifting(false),
+_j(0), _jNumbers(nullptr), _jNumbersCapacity(0), _signalSize(0), _loBandSize(0),
+_pSpectrum(nullptr), _pTmpSpectrum(nullptr), _spectrumCapacity(0), _pHiData(nullptr), _pLoData(nullptr), _hiNum(0), _loNum(0)
 {
 }
 
-FastWaveletTransform::~FastWaveletTransform()
+template <typename T>
+FastWaveletTransformT<T>::~FastWaveletTransformT()
 {
-	if (_tH) delete[] _tH;
-	if (_tG) delete[] _tG;
-	if (_h) delete[] _h;
-	if (_g) delete[] _g;
+	if (_pTaps) delete[] _pTaps;
 
 	if (_pSpectrum) free(_pSpectrum);
 	if (_pTmpSpectrum) free(_pTmpSpectrum);
+	if (_pChannels) free(_pChannels);
 
 	if (_jNumbers) delete[] _jNumbers;
 }
 
-bool FastWaveletTransform::init(const double* data, int size, const char* filterName)
+template <typename T>
+bool FastWaveletTransformT<T>::init(const T* data, int size, const char* filterName, bool lifting)
+{
+	return init(data, size, 0, CONSTANT_EXTENSION, filterName, lifting);
+}
+
+template <typename T>
+bool FastWaveletTransformT<T>::init(const T* data, int size, int pad, enum EXTENSION extension, const char* filterName,
+                                    bool lifting)
 {
-	FILE *filter;
-	std::string file = _filterDir + filterName;
-	fopen_s(&filter, file.c_str(), "rt");
+	const int signalSize = size;
+	size += 2 * pad;
+
+	bool builtIn;
+	const WAVELET_FILTER *filter = _findFilter(filterName, builtIn);
 	if (filter) {
-		_tH = _loadFilter(filter, _thL, _thZ);
-		_tG = _loadFilter(filter, _tgL, _tgZ);
-		_h = _loadFilter(filter, _hL, _hZ);
-		_g = _loadFilter(filter, _gL, _gZ);
-		fclose(filter);
+		if (filter != _pFilter || lifting != _lifting) {     //filters are reloaded on a new name only
+			const int length = filter->length[0] + filter->length[1] + filter->length[2] + filter->length[3];
+			if (length > _tapCapacity) {
+				if (_pTaps) delete[] _pTaps;
+				_pTaps = new T[length];
+				_tapCapacity = length;
+			}
+
+			const double *taps = filter->taps;
+			_tH = _copyFilter(taps, filter->length[0], filter->center[0], _pTaps, _thL, _thZ);
+			_tG = _copyFilter(taps += _thL, filter->length[1], filter->center[1], _tH + _thL, _tgL, _tgZ);
+			_h = _copyFilter(taps += _tgL, filter->length[2], filter->center[2], _tG + _tgL, _hL, _hZ);
+			_g = _copyFilter(taps += _hL, filter->length[3], filter->center[3], _h + _hL, _gL, _gZ);
+
+			_pAnalysisLifting = nullptr;
+			_pSynthesisLifting = nullptr;
+			_liftMargin = 0;
+			if (lifting && builtIn) {
+				_pAnalysisLifting = _findLifting(filterName, false);
+				_pSynthesisLifting = _findLifting(filterName, true);
+			}
+			if (_pAnalysisLifting && _pSynthesisLifting)
+				_liftMargin = std::max(_liftingMargin(_pAnalysisLifting), _liftingMargin(_pSynthesisLifting));
+			else
+				_pAnalysisLifting = _pSynthesisLifting = nullptr;
+			_convMargin = std::max(std::max(_thL, _tgL), std::max(_hL, _gL));
+
+			_pFilter = filter;
+			_lifting = lifting;
+		}
+
+		//buffers kept at their high-water mark until close()
+		const int channels = 2 * (size / 2 + 2 * std::max(_liftMargin, _convMargin));
+		if (channels > _channelCapacity) {
+			if (_pChannels) free(_pChannels);
+			_pChannels = static_cast<T *>(malloc(sizeof(T) * channels));
+			_channelCapacity = channels;
+		}
+		if (size > _spectrumCapacity) {
+			if (_pSpectrum) free(_pSpectrum);
+			if (_pTmpSpectrum) free(_pTmpSpectrum);
+			_pSpectrum = static_cast<T *>(malloc(sizeof(T) * size));
+			_pTmpSpectrum = static_cast<T *>(malloc(sizeof(T) * size));
+			_spectrumCapacity = size;
+		}
 
 		_loBandSize = size;
 		_signalSize = size;
-		_pSpectrum = static_cast<double *>(malloc(sizeof(double) * size));
-		_pTmpSpectrum = static_cast<double *>(malloc(sizeof(double) * size));
 		_pLoData = _pTmpSpectrum;
 		_pHiData = _pTmpSpectrum + size;
 
-		for (int i = 0; i < size; i++)
-			_pSpectrum[i] = data[i];
-		memset(_pTmpSpectrum, 0, sizeof(double)*size);
+		_padSignal(data, signalSize, pad, extension, _pSpectrum);
 
 		_j = 0;
 
@@ -55,37 +188,51 @@ bool FastWaveletTransform::init(const double* data, int size, const char* filter
 	return false;
 }
 
-double* FastWaveletTransform::_loadFilter(FILE* filter, int& L, int& Z)
+template <typename T>
+void FastWaveletTransformBase::_padSignal(const T *data, int size, int pad, enum EXTENSION extension, T *out)
 {
-	fscanf(filter, "%d", &L);
-	fscanf(filter, "%d", &Z);
+	memcpy(out + pad, data, sizeof(T) * size);
+
+	if (extension == MIRROR_EXTENSION && size > 1) {
+		const int period = 2 * size - 2;               //folded again for pads longer than the signal
+		for (int k = 1; k <= pad; k++) {
+			const int n = k % period;
+			out[pad - k] = data[n < size ? n : period - n];
+			out[pad + size - 1 + k] = data[size - 1 - (n < size ? n : period - n)];
+		}
+	}
+	else {
+		for (int k = 1; k <= pad; k++) {
+			out[pad - k] = data[0];
+			out[pad + size - 1 + k] = data[size - 1];
+		}
+	}
+}
 
-	double *flt = new double[L];
+template void FastWaveletTransformBase::_padSignal<double>(const double*, int, int, enum EXTENSION, double*);
+template void FastWaveletTransformBase::_padSignal<float>(const float*, int, int, enum EXTENSION, float*);
+
+template <typename T>
+T* FastWaveletTransformT<T>::_copyFilter(const double *taps, int length, int center, T *flt, int& L, int& Z)
+{
+	L = length;
+	Z = center;
 
 	for (int i = 0; i < L; i++)
-		fscanf(filter, "%lf", &flt[i]);
+		flt[i] = T(taps[i]);
 
 	return flt;
 }
 
-void FastWaveletTransform::close()
+template <typename T>
+void FastWaveletTransformT<T>::close()
 {
-	if (_tH) {
-		delete[] _tH;
-		_tH = nullptr;
-	}
-	if (_tG) {
-		delete[] _tG;
-		_tG = nullptr;
-	}
-	if (_h) {
-		delete[] _h;
-		_h = nullptr;
-	}
-	if (_g) {
-		delete[] _g;
-		_g = nullptr;
+	if (_pTaps) {
+		delete[] _pTaps;
+		_pTaps = nullptr;
 	}
+	_tapCapacity = 0;
+	_tH = _tG = _h = _g = nullptr;
 
 	if (_pSpectrum) {
 		free(_pSpectrum);
@@ -95,22 +242,114 @@ void FastWaveletTransform::close()
 		free(_pTmpSpectrum);
 		_pTmpSpectrum = nullptr;
 	}
+	if (_pChannels) {
+		free(_pChannels);
+		_pChannels = nullptr;
+	}
+	_spectrumCapacity = 0;
+	_channelCapacity = 0;
+	_pAnalysisLifting = nullptr;
+	_pSynthesisLifting = nullptr;
+	_pFilter = nullptr;
 
 	if (_jNumbers) {
 		delete[] _jNumbers;
 		_jNumbers = nullptr;
 	}
+	_jNumbersCapacity = 0;
 }
 
 
 //////////////////////transforms///////////////////////////////////////////////////////////////////
-void FastWaveletTransform::_hiLoTransform() const
+static inline int mirrorIndex(int n, int size)
+{
+	if (n < 0) n = 0 - n;
+	if (n >= size) n -= (2 + n - size);
+	return n;
+}
+
+//even x[2k] and odd x[2k+1] channels of the level input over [-margin, half + margin),
+//symmetric extension at the edges only
+template <typename T>
+void FastWaveletTransformT<T>::_splitChannels(int margin, T *&even, T *&odd) const
+{
+	const int half = _loBandSize / 2;
+	even = _pChannels + margin;
+	odd = even + half + 2 * margin;
+
+	int k = -margin;
+	for (; k < 0; k++) {
+		even[k] = _pSpectrum[mirrorIndex(2 * k, _loBandSize)];
+		odd[k] = _pSpectrum[mirrorIndex(2 * k + 1, _loBandSize)];
+	}
+	for (; 2 * k + 1 < _loBandSize; k++) {
+		even[k] = _pSpectrum[2 * k];
+		odd[k] = _pSpectrum[2 * k + 1];
+	}
+	for (; k < half + margin; k++) {
+		even[k] = _pSpectrum[mirrorIndex(2 * k, _loBandSize)];
+		odd[k] = _pSpectrum[mirrorIndex(2 * k + 1, _loBandSize)];
+	}
+}
+
+//lo and hi bands of the level over [-margin, _loBandSize + margin)
+template <typename T>
+void FastWaveletTransformT<T>::_extendBands(int margin, T *&lo, T *&hi) const
+{
+	const T *hiBand = _pSpectrum + (_pHiData - _pTmpSpectrum);
+	lo = _pChannels + margin;
+	hi = lo + _loBandSize + 2 * margin;
+
+	memcpy(lo, _pSpectrum, sizeof(T) * _loBandSize);
+	memcpy(hi, hiBand, sizeof(T) * _loBandSize);
+	for (int k = 1; k <= margin; k++) {
+		lo[-k] = _pSpectrum[mirrorIndex(-k, _loBandSize)];
+		hi[-k] = hiBand[mirrorIndex(-k, _loBandSize)];
+		lo[_loBandSize - 1 + k] = _pSpectrum[mirrorIndex(_loBandSize - 1 + k, _loBandSize)];
+		hi[_loBandSize - 1 + k] = hiBand[mirrorIndex(_loBandSize - 1 + k, _loBandSize)];
+	}
+}
+
+//polyphase convolution: tap m of x[2k+m] is channel m&1 at k + floor(m/2), so every tap is one
+//vector pass over a block of outputs, in the tap order of the per sample sums
+template <typename T>
+void FastWaveletTransformT<T>::_hiLoTransform() const
+{
+	const int half = _loBandSize / 2;
+	T *channel[2];
+	_splitChannels(_convMargin, channel[0], channel[1]);
+	T *hi = _pSpectrum + (_pHiData - _pTmpSpectrum);
+
+	T s[POLYPHASE_BLOCK];
+	T d[POLYPHASE_BLOCK];
+	for (int k0 = 0; k0 < half; k0 += POLYPHASE_BLOCK) {
+		const int count = std::min(POLYPHASE_BLOCK, half - k0);
+		memset(s, 0, sizeof(T) * count);
+		memset(d, 0, sizeof(T) * count);
+
+		for (int m = -_thZ; m < _thL - _thZ; m++) {
+			if (_tH[m + _thZ] != 0)
+				Axpy(_tH[m + _thZ], channel[m & 1] + k0 + (m - (m & 1)) / 2, count, s);
+		}
+		for (int m = -_tgZ; m < _tgL - _tgZ; m++) {
+			if (_tG[m + _tgZ] != 0)
+				Axpy(_tG[m + _tgZ], channel[m & 1] + k0 + (m - (m & 1)) / 2, count, d);
+		}
+
+		memcpy(_pSpectrum + k0, s, sizeof(T) * count);
+		memcpy(hi + k0, d, sizeof(T) * count);
+	}
+}
+
+//per sample sums with symmetric extension at every tap, bands shorter than the channel margin
+template <typename T>
+void FastWaveletTransformT<T>::_shortTransform() const
 {
 	int n;
 
 	for (int k = 0; k < _loBandSize / 2; k++) {
-		double s = 0;
-		double d = 0;
+		T s = 0;
+		T d = 0;
 
 		for (int m = -_thZ; m < _thL - _thZ; m++) {
 			n = 2 * k + m;
@@ -130,31 +369,83 @@ void FastWaveletTransform::_hiLoTransform() const
 		_pHiData[k] = d;
 	}
 
-	for (int i = 0; i < _signalSize; i++)
-		_pSpectrum[i] = _pTmpSpectrum[i];
+	//bands back over the level input, the rest of _pSpectrum is unchanged
+	const int half = _loBandSize / 2;
+	T *hi = _pSpectrum + (_pHiData - _pTmpSpectrum);
+	for (int k = 0; k < half; k++) {
+		_pSpectrum[k] = _pLoData[k];
+		hi[k] = _pHiData[k];
+	}
 }
 
-void FastWaveletTransform::transform(const int scales)
+template <typename T>
+void FastWaveletTransformT<T>::transform(const int scales)
 {
 	for (int j = 0; j < scales; j++) {
-		_pHiData -= _loBandSize / 2;
-		_hiLoTransform();
+		const int half = _loBandSize / 2;
+		_pHiData -= half;
+		if (_pAnalysisLifting && half > 2 * _liftMargin)
+			_liftTransform();
+		else if (half > 2 * _convMargin)
+			_hiLoTransform();
+		else
+			_shortTransform();
 
 		_loBandSize /= 2;
 		_j++;
 	}
 }
 
-void FastWaveletTransform::_hiLoSynthesis() const
+//x[2k] from h[2m] and g[2m] taps, x[2k+1] from h[2m+1] and g[2m+1] taps of lo[k-m] and hi[k-m]
+template <typename T>
+void FastWaveletTransformT<T>::_hiLoSynthesis() const
+{
+	T *lo, *hi;
+	_extendBands(_convMargin, lo, hi);
+
+	T s2K[POLYPHASE_BLOCK];
+	T s2K1[POLYPHASE_BLOCK];
+	for (int k0 = 0; k0 < _loBandSize; k0 += POLYPHASE_BLOCK) {
+		const int count = std::min(POLYPHASE_BLOCK, _loBandSize - k0);
+		memset(s2K, 0, sizeof(T) * count);
+		memset(s2K1, 0, sizeof(T) * count);
+
+		for (int m = -_hZ; m < _hL - _hZ; m++) {
+			if (2 * m >= -_hZ && 2 * m < _hL - _hZ && _h[2 * m + _hZ] != 0)
+				Axpy(_h[2 * m + _hZ], lo + k0 - m, count, s2K);
+			if (2 * m + 1 >= -_hZ && 2 * m + 1 < _hL - _hZ && _h[2 * m + 1 + _hZ] != 0)
+				Axpy(_h[2 * m + 1 + _hZ], lo + k0 - m, count, s2K1);
+		}
+		for (int m = -_gZ; m < _gL - _gZ; m++) {
+			if (2 * m >= -_gZ && 2 * m < _gL - _gZ && _g[2 * m + _gZ] != 0)
+				Axpy(_g[2 * m + _gZ], hi + k0 - m, count, s2K);
+			if (2 * m + 1 >= -_gZ && 2 * m + 1 < _gL - _gZ && _g[2 * m + 1 + _gZ] != 0)
+				Axpy(_g[2 * m + 1 + _gZ], hi + k0 - m, count, s2K1);
+		}
+
+		T *x = _pSpectrum + 2 * k0;
+		for (int k = 0; k < count; k++) {
+			x[2 * k] = 2 * s2K[k];
+			x[2 * k + 1] = 2 * s2K1[k];
+		}
+	}
+}
+
+template <typename T>
+void FastWaveletTransformT<T>::_shortSynthesis() const
 {
 	int n;
 
-	for (int i = 0; i < _signalSize; i++)
-		_pTmpSpectrum[i] = _pSpectrum[i];
+	//lo and hi bands are overwritten by the output, work on copies of them
+	const T *hi = _pSpectrum + (_pHiData - _pTmpSpectrum);
+	for (int k = 0; k < _loBandSize; k++) {
+		_pLoData[k] = _pSpectrum[k];
+		_pHiData[k] = hi[k];
+	}
 
 	for (int k = 0; k < _loBandSize; k++) {
-		double s2K = 0;
-		double s2K1 = 0;
+		T s2K = 0;
+		T s2K1 = 0;
 
 		for (int m = -_hZ; m < _hL - _hZ; m++) {       //s2k and s2k1 for H[]
 			n = k - m;
@@ -178,15 +469,22 @@ void FastWaveletTransform::_hiLoSynthesis() const
 				s2K1 += _g[(2 * m + 1) + _gZ] * _pHiData[n];
 		}
 
-		_pSpectrum[2 * k] = 2.0 * s2K;
-		_pSpectrum[2 * k + 1] = 2.0 * s2K1;
+		_pSpectrum[2 * k] = 2 * s2K;
+		_pSpectrum[2 * k + 1] = 2 * s2K1;
 	}
 }
 
-void FastWaveletTransform::synthesis(int scales)
+template <typename T>
+void FastWaveletTransformT<T>::synthesis(int scales)
 {
 	for (int j = 0; j < scales; j++) {
-		_hiLoSynthesis();
+		const bool fits = _loBandSize <= _signalSize / 2;    //channels hold half the signal
+		if (fits && _pSynthesisLifting && _loBandSize > 2 * _liftMargin)
+			_liftSynthesis();
+		else if (fits && _loBandSize > 2 * _convMargin)
+			_hiLoSynthesis();
+		else
+			_shortSynthesis();
 		_pHiData += _jNumbers[j];
 
 		_loBandSize *= 2;
@@ -195,12 +493,111 @@ void FastWaveletTransform::synthesis(int scales)
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+//////////////////////lifting///////////////////////////////////////////////////////////////////
+// factorizations of the built-in filter banks of the same name, not used for filter files read
+// from the filter directory. daub2 equals its file taps to 1e-11, bior97 is the exact
+// CDF 9/7 pair that the 5 digit file taps round, to 1e-5, with exact reconstruction
+static const struct {
+	const char *filter;
+	FastWaveletTransformBase::LIFTING analysis;
+	FastWaveletTransformBase::LIFTING synthesis;
+} liftingSchemes[] = {
+	{ "daub2.flt",
+	  { 3, { { 0, 1, 1, { -0.57735026918849852 } },
+	         { 1, -1, 2, { 0.43301270189266938, 0.2009618943233451 } },
+	         { 0, 0, 1, { -0.33333333333293941 } } },
+	    { 0, 1 }, { 0, 0 }, { 0.78867513459424909, 0.6339745962152481 } },
+	  { 3, { { 0, 0, 1, { -3.7320508075699563 } },
+	         { 1, 0, 2, { 0.2499999999999824, 0.11602540378431166 } },
+	         { 0, -1, 1, { -6.4641016151470874 } } },
+	    { 0, 1 }, { -1, 1 }, { -2.7320508075699563, -0.73205080756770324 } } },
+	{ "bior97.flt",
+	  { 4, { { 1, -1, 2, { -1.5861343420594238, -1.5861343420594238 } },
+	         { 0, 0, 2, { -0.052980118573376672, -0.052980118573376672 } },
+	         { 1, -1, 2, { 0.88291107552850301, 0.88291107552850301 } },
+	         { 0, 0, 2, { 0.44350685204498297, 0.44350685204498297 } } },
+	    { 1, 0 }, { -1, 0 }, { 0.8128930661160001, 0.61508705245806261 } },
+	  { 4, { { 1, -1, 2, { -0.58613434206569104, -0.58613434206569104 } },
+	         { 0, 0, 2, { -0.66806717101412505, -0.66806717101412505 } },
+	         { 1, -1, 2, { 0.070018009417398136, 0.070018009417398136 } },
+	         { 0, 0, 2, { 1.2001710162279751, 1.2001710162279751 } } },
+	    { 1, 0 }, { 0, 1 }, { 1.6257861322319997, 1.2301741049212622 } } }
+};
+
+const FastWaveletTransformBase::LIFTING* FastWaveletTransformBase::_findLifting(const char *filterName, bool synthesis)
+{
+	for (const auto &scheme : liftingSchemes) {
+		if (!strcmp(scheme.filter, filterName))
+			return synthesis ? &scheme.synthesis : &scheme.analysis;
+	}
+	return nullptr;
+}
 
-int* FastWaveletTransform::GetJNumbers(int j, int size)
+int FastWaveletTransformBase::_liftingMargin(const LIFTING *lifting)
 {
-	if (_jNumbers) delete[] _jNumbers;
+	int margin = 1;
+	for (int s = 0; s < lifting->steps; s++) {
+		const LIFTING_STEP &step = lifting->step[s];
+		margin += std::max(abs(step.first), abs(step.first + step.count - 1));
+	}
+	return margin + std::max(abs(lifting->shift[0]), abs(lifting->shift[1]));
+}
+
+//even, odd: channels over [-_liftMargin, count + _liftMargin), lifted in place
+template <typename T>
+void FastWaveletTransformT<T>::_lift(const LIFTING *lifting, T *even, T *odd, int count, T *out0, T *out1, int stride) const
+{
+	T *channel[2] = { even, odd };
+	const int from = -_liftMargin;
+	const int to = count + _liftMargin;
+
+	for (int s = 0; s < lifting->steps; s++) {
+		const LIFTING_STEP &step = lifting->step[s];
+		T *target = channel[step.update ? 0 : 1];
+		const T *source = channel[step.update ? 1 : 0] + step.first;
+		const int k0 = from + std::max(0, -step.first);
+		const int k1 = to - std::max(0, step.first + step.count - 1);
+
+		for (int i = 0; i < step.count; i++)
+			Axpy(T(step.taps[i]), source + k0 + i, k1 - k0, target + k0);
+	}
+
+	const T *c0 = channel[lifting->channel[0]] + lifting->shift[0];
+	const T *c1 = channel[lifting->channel[1]] + lifting->shift[1];
+	const T scale0 = T(lifting->scale[0]);
+	const T scale1 = T(lifting->scale[1]);
+	for (int k = 0; k < count; k++) {
+		out0[k * stride] = scale0 * c0[k];
+		out1[k * stride] = scale1 * c1[k];
+	}
+}
 
-	_jNumbers = new int[j];
+template <typename T>
+void FastWaveletTransformT<T>::_liftTransform() const
+{
+	T *even, *odd;
+	_splitChannels(_liftMargin, even, odd);
+	_lift(_pAnalysisLifting, even, odd, _loBandSize / 2, _pSpectrum, _pSpectrum + (_pHiData - _pTmpSpectrum), 1);
+}
+
+template <typename T>
+void FastWaveletTransformT<T>::_liftSynthesis() const
+{
+	T *lo, *hi;
+	_extendBands(_liftMargin, lo, hi);
+	_lift(_pSynthesisLifting, lo, hi, _loBandSize, _pSpectrum, _pSpectrum + 1, 2);   //x[2k], x[2k+1]
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+template <typename T>
+int* FastWaveletTransformT<T>::GetJNumbers(int j, int size)
+{
+	if (j > _jNumbersCapacity) {
+		if (_jNumbers) delete[] _jNumbers;
+		_jNumbers = new int[j];
+		_jNumbersCapacity = j;
+	}
 
 	for (int i = 0; i < j; i++)
 		_jNumbers[i] = size / int(pow(2, double(j - i)));
@@ -208,7 +605,7 @@ int* FastWaveletTransform::GetJNumbers(int j, int size)
 	return _jNumbers;
 }
 
-void FastWaveletTransform::hiLoNumbers(int j, int size, int &hiNum, int &loNum)
+void FastWaveletTransformBase::hiLoNumbers(int j, int size, int &hiNum, int &loNum)
 {
 	loNum = 0;
 	hiNum = 0;
@@ -219,6 +616,9 @@ void FastWaveletTransform::hiLoNumbers(int j, int size, int &hiNum, int &loNum)
 	}
 	loNum = size;
 }
+
+template class FastWaveletTransformT<double>;
+template class FastWaveletTransformT<float>;
 /*
 bool FastWaveletTransform::FwtSaveFile(const wchar_t *name, const double *hipass, const double *lopass, PFWTHDR hdr)
 {
@@ -3,17 +3,80 @@
 #include "ecgtypes.h"
 #include <string>
 
-class FastWaveletTransform
+struct WAVELET_FILTER;
+
+//filters and band sizes shared by the double and float, decimated and stationary transforms
+class FastWaveletTransformBase
 {
 public:
-	FastWaveletTransform();
-	~FastWaveletTransform();
+	// Data
+	enum EXTENSION { MIRROR_EXTENSION, CONSTANT_EXTENSION };   //padding added by init(data, size, pad, ...)
+
+	static void hiLoNumbers(int j, int size, int &hiNum, int &loNum);
+
+	//filter files in filterDir override the built-in filters of the same name, each file is read
+	//once; "" or nullptr (default): built-in filters only, no file access
+	static void setFilterDir(const char* filterDir)
+	{
+        _filterDir = filterDir ? filterDir : "";
+        if (!_filterDir.empty()) {
+            char c=*_filterDir.rbegin();
+            if(c != '\\' && c!='/'){
+                _filterDir.append("/");
+            }
+        }
+    }
+    static const char* getFilterDir(){
+        return _filterDir.c_str();
+    }
+
+	//lifting factorization of a filter bank on the even and odd polyphase channels
+	//(x[2k], x[2k+1] for analysis, lo[k], hi[k] for synthesis): each step adds
+	//taps[i] * source[k + first + i] to the other channel, then
+	//output j [k] = scale[j] * channel[j] [k + shift[j]], lo/hi or x[2k]/x[2k+1]
+	struct LIFTING_STEP {
+		int update;                  //0: odd += taps * even, 1: even += taps * odd
+		int first;
+		int count;
+		double taps[2];
+	};
+	struct LIFTING {
+		int steps;
+		LIFTING_STEP step[4];
+		int channel[2];
+		int shift[2];
+		double scale[2];
+	};
+
+protected:
+	static std::string _filterDir;
+
+	static const WAVELET_FILTER* _findFilter(const char *filterName, bool &builtIn);
+	//out[0, size + 2 pad) = data over [-pad, size + pad), whole sample mirror or edge values
+	template <typename T> static void _padSignal(const T *data, int size, int pad, enum EXTENSION extension, T *out);
+
+	static const LIFTING* _findLifting(const char *filterName, bool synthesis);
+	static int _liftingMargin(const LIFTING *lifting);
+};
+
+//T = double, or float for half the memory traffic; filters are loaded in double and stored in T
+template <typename T>
+class FastWaveletTransformT : public FastWaveletTransformBase
+{
+public:
+	FastWaveletTransformT();
+	~FastWaveletTransformT();
 
 	// Operators
 			//const FWT& operator=(const FWT& fwt);
 
 	// Operations
-    bool init(const double* data, int size, const char* filter);
+	//buffers are kept at their high-water mark and filters reloaded only for another filter, so
+	//repeated init() calls on records up to the largest size so far do not allocate; close() frees
+    bool init(const T* data, int size, const char* filter, bool lifting = true);   //filter: "daub2.flt"; lifting: daub2, bior97
+	//transform of data with pad extension samples on both sides, size + 2 pad samples, padded
+	//while it is copied in
+	bool init(const T* data, int size, int pad, enum EXTENSION extension, const char* filter, bool lifting = true);
 	void close();
 
 	void transform(int scales);                      //wavelet transform
@@ -23,68 +86,78 @@ public:
 	//bool FwtReadFile(const wchar_t *name, const char *appdir = 0);
 
 	// Access
-	inline double* GetFwtSpectrum() const;
+	inline T* GetFwtSpectrum() const;
 	inline int getLoBandSize() const;
 	inline int getJ() const;
 	int* GetJNumbers(int j, int size);
 
-	static void hiLoNumbers(int j, int size, int &hiNum, int &loNum);
-
-	static void setFilterDir(const char* filterDir)
-	{
-        _filterDir = filterDir ? filterDir : "";
-        char c=*_filterDir.rbegin();
-        if(c != '\\' && c!='/'){
-            _filterDir.append("/");
-        }
-    }
-    static const char* getFilterDir(){
-        return _filterDir.c_str();
-    }
-protected:
-	static std::string _filterDir;
-
 private:
-	FastWaveletTransform(const FastWaveletTransform& fwt) = delete;
-	const FastWaveletTransform& operator=(const FastWaveletTransform& fwt) = delete;
+	FastWaveletTransformT(const FastWaveletTransformT& fwt) = delete;
+	const FastWaveletTransformT& operator=(const FastWaveletTransformT& fwt) = delete;
 
-	static double* _loadFilter(FILE* fp, int &L, int &Z);
-	void _hiLoTransform() const;
+	static T* _copyFilter(const double *taps, int length, int center, T *flt, int &L, int &Z);
+	void _hiLoTransform() const;                    //polyphase convolution
 	void _hiLoSynthesis() const;
+	void _shortTransform() const;                   //bands within the channel margin
+	void _shortSynthesis() const;
+	void _liftTransform() const;
+	void _liftSynthesis() const;
+	void _splitChannels(int margin, T *&even, T *&odd) const;
+	void _extendBands(int margin, T *&lo, T *&hi) const;
+	void _lift(const LIFTING *lifting, T *even, T *odd, int count, T *out0, T *out1, int stride) const;
 
 	PFWT_HEADER _pHDR;
 	
-	double *_tH, *_tG;     //analysis filters
-	double *_h, *_g;       //synth filters
+	T *_tH, *_tG;          //analysis filters
+	T *_h, *_g;            //synth filters
+	T *_pTaps;             //storage of the four filters
+	int _tapCapacity;
 	int _thL, _tgL, _hL, _gL;     //filters lenghts
 	int _thZ, _tgZ, _hZ, _gZ;     //filter centers
 
+	const LIFTING *_pAnalysisLifting;   //nullptr: convolution with the filters above
+	const LIFTING *_pSynthesisLifting;
+	int _liftMargin;       //channel extension covering all lifting steps
+	int _convMargin;       //channel extension covering the filters
+	T *_pChannels;         //mirror extended even and odd channels
+	int _channelCapacity;
+	const WAVELET_FILTER *_pFilter;     //filter bank loaded in the arrays above
+	bool _lifting;
+
 	int _j;                //scales
 	int *_jNumbers;          //hi values per scale
+	int _jNumbersCapacity;
 	int _signalSize;       //signal size
 	int _loBandSize;       //divided signal size
 
 	//spectra
-	double *_pSpectrum;              //buffer with fwt spectra
-	double *_pTmpSpectrum;              //temporary
-	double *_pHiData;
-	double *_pLoData;
+	T *_pSpectrum;                   //buffer with fwt spectra
+	T *_pTmpSpectrum;                   //convolution scratch, same layout as _pSpectrum
+	int _spectrumCapacity;
+	T *_pHiData;                        //current hi band in _pTmpSpectrum
+	T *_pLoData;
 	int _hiNum;
 	int _loNum;
 };
 
+typedef FastWaveletTransformT<double> FastWaveletTransform;
+typedef FastWaveletTransformT<float> FastWaveletTransformF;
+
 // Inlines
-inline double* FastWaveletTransform::GetFwtSpectrum() const
+template <typename T>
+inline T* FastWaveletTransformT<T>::GetFwtSpectrum() const
 {
 	return _pSpectrum;
 }
 
-inline int FastWaveletTransform::getLoBandSize() const
+template <typename T>
+inline int FastWaveletTransformT<T>::getLoBandSize() const
 {
 	return _loBandSize;
 }
 
-int FastWaveletTransform::getJ() const
+template <typename T>
+int FastWaveletTransformT<T>::getJ() const
 {
 	return _j;
 }
@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "MultiLeadAnnotator.h"
+#include "signal.h"
+
+MultiLeadAnnotator::MultiLeadAnnotator(PANN_HEADER p) : _annotator(p), _tolerance(0.1), _votes(0), _threads(0)
+{
+}
+
+void MultiLeadAnnotator::setTolerance(double tolerance)
+{
+	_tolerance = tolerance;
+}
+
+void MultiLeadAnnotator::setVotes(int votes)
+{
+	_votes = votes;
+}
+
+void MultiLeadAnnotator::setThreads(int threads)
+{
+	_threads = threads;
+}
+
+int MultiLeadAnnotator::getLeadsNum() const
+{
+	return int(_leadAnn.size());
+}
+
+int MultiLeadAnnotator::getQRSNumber() const
+{
+	return _qrsAnn.getSize() / 2;
+}
+
+AnnotationView MultiLeadAnnotator::getQRSAnnotation() const
+{
+	return _qrsAnn;
+}
+
+const std::vector<int>& MultiLeadAnnotator::getVotes() const
+{
+	return _beatVotes;
+}
+
+AnnotationView MultiLeadAnnotator::getLeadAnnotation(int lead) const
+{
+	if (lead < 0 || lead >= int(_leadAnn.size()))
+		return AnnotationView();
+	return _leadAnn[lead];
+}
+
+AnnotationView MultiLeadAnnotator::getLeadQRSAnnotation(int lead) const
+{
+	if (lead < 0 || lead >= int(_leadQrs.size()))
+		return AnnotationView();
+	return _leadQrs[lead];
+}
+
+ANN_HEADER* MultiLeadAnnotator::getAnnotationHeader()
+{
+	return _annotator.getAnnotationHeader();
+}
+
+int MultiLeadAnnotator::annotate(class Signal *signal)
+{
+	const int leads = signal->GetLeadsNum();
+	_leadAnn.clear();
+	_leadQrs.clear();
+	_leadAnn.resize(size_t(leads));
+	_leadQrs.resize(size_t(leads));
+	_qrsAnn.clear();
+	_beatVotes.clear();
+	if (leads == 0)
+		return 0;
+
+	const double sampleRate = signal->GetSR(0);
+	const ANN_HEADER hdr = *_annotator.getAnnotationHeader();
+
+	int threads = _threads;
+	if (threads <= 0)
+		threads = int(std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, leads));
+
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		Annotator annotator;                          //workspace reused by the leads of this worker
+		for (int lead = next++; lead < leads; lead = next++) {
+			if (signal->GetSR(lead) != sampleRate)
+				continue;
+			*annotator.getAnnotationHeader() = hdr;   //getQRS may lower maxbpm of the previous lead
+
+			const double *data = signal->GetData(lead);
+			const int length = signal->GetLength(lead);
+			AnnotationTable *qrs = annotator.getQRS(data, length, sampleRate);
+			if (!qrs)
+				continue;
+			annotator.getEctopia(*qrs, sampleRate);
+			_leadQrs[lead].assign(*qrs);
+
+			if (annotator.getPTU(data, length, sampleRate, *qrs, threads > 1 ? 1 : 0))
+				_leadAnn[lead].assign(annotator.getAnnotation());
+			else
+				_leadAnn[lead].assign(*qrs);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+
+	_fuse(sampleRate);
+	return getQRSNumber();
+}
+
+//middle value, mean of the two middle ones for an even count so 2 leads do not favour the earlier
+static int median(std::vector<int> &values)
+{
+	const size_t half = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + half, values.end());
+	if (values.size() % 2)
+		return values[half];
+	const int upper = values[half];
+	const int lower = *std::max_element(values.begin(), values.begin() + half);
+	return lower + (upper - lower) / 2;
+}
+
+//beats of all leads in onset order: each one not yet matched opens a window of 2 tolerance, the first
+//beat of every lead in it is a candidate and the candidates within tolerance of their median onset
+//make the beat. An outlying onset of a noisy lead is left out rather than shifting the window
+void MultiLeadAnnotator::_fuse(double sampleRate)
+{
+	struct Beat {
+		int onset;
+		int offset;
+		int lead;
+	};
+	std::vector<Beat> beats;
+	int annotated = 0;
+	for (int lead = 0; lead < int(_leadQrs.size()); lead++) {
+		const AnnotationView qrs = _leadQrs[lead];
+		if (qrs.empty())
+			continue;
+		annotated++;
+		for (int i = 0; i + 1 < qrs.getSize(); i += 2)
+			beats.push_back({ qrs.sample(i), qrs.sample(i + 1), lead });
+	}
+	std::stable_sort(beats.begin(), beats.end(), [](const Beat &a, const Beat &b) { return a.onset < b.onset; });
+
+	const int votes = _votes > 0 ? _votes : annotated / 2 + 1;     //strict majority
+	const int tolerance = int(_tolerance * sampleRate);
+
+	std::vector<char> matched(beats.size(), 0);
+	std::vector<char> voted(_leadQrs.size(), 0);
+	std::vector<size_t> candidates;
+	std::vector<int> onsets, offsets;
+	for (size_t i = 0; i < beats.size(); i++) {
+		if (matched[i])
+			continue;
+
+		std::fill(voted.begin(), voted.end(), 0);
+		candidates.clear();
+		onsets.clear();
+		for (size_t j = i; j < beats.size() && beats[j].onset - beats[i].onset <= 2 * tolerance; j++) {
+			if (matched[j] || voted[beats[j].lead])
+				continue;
+			voted[beats[j].lead] = 1;
+			candidates.push_back(j);
+			onsets.push_back(beats[j].onset);
+		}
+		const int center = median(onsets);
+
+		onsets.clear();
+		offsets.clear();
+		for (size_t c = 0; c < candidates.size(); c++) {
+			const Beat &beat = beats[candidates[c]];
+			if (std::abs(beat.onset - center) > tolerance)
+				continue;
+			matched[candidates[c]] = 1;
+			onsets.push_back(beat.onset);
+			offsets.push_back(beat.offset);
+		}
+
+		const int count = int(onsets.size());
+		if (count < votes)
+			continue;
+		const int onset = median(onsets);
+		const int offset = std::max(onset, median(offsets));
+
+		//overlapping the previous beat: the one with more votes stays
+		const int qrsNum = _qrsAnn.getSize() / 2;
+		if (qrsNum && onset <= _qrsAnn.getSamples()[2 * qrsNum - 1]) {
+			if (count <= _beatVotes.back())
+				continue;
+			_qrsAnn.resize(2 * (qrsNum - 1));
+			_beatVotes.pop_back();
+		}
+		_qrsAnn.add(onset, 1);                        //type N
+		_qrsAnn.add(offset, 40);                      //type QRS)
+		_beatVotes.push_back(count);
+	}
+
+	_annotator.getEctopia(_qrsAnn, sampleRate);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include "Annotator.h"
+
+//Annotator over all leads of a Signal: getQRS, getEctopia and getPTU run on the leads in parallel,
+//leads shared by threads workers with an Annotator each. The QRS onset, offset pairs of the leads are
+//then matched by their onsets within tolerance seconds of the median, a lead voting once per beat,
+//and beats with enough votes make the consensus QRS annotation: median onset and offset of the leads
+//that found it, ectopic beats labelled on the consensus RR intervals. By default a beat needs a strict
+//majority of the leads annotated: a false beat of a noisy lead is voted out, and from 3 leads on a
+//beat it missed is still kept (on 2 leads both must find it, setVotes(1) keeps either). Leads of
+//another sample rate than lead 0 are skipped
+class MultiLeadAnnotator
+{
+public:
+	MultiLeadAnnotator(PANN_HEADER p = nullptr);
+
+	// Operations
+	void setTolerance(double tolerance);     //secs from the median QRS onset of a beat, 0.1 by default
+	void setVotes(int votes);                //leads to keep a beat, 0 = strict majority of the leads annotated (default)
+	void setThreads(int threads);            //lead workers, 0 = all cores
+
+	int annotate(class Signal *signal);      //returns consensus beats, 0 if none found
+
+	// Access
+	int getLeadsNum() const;
+	int getQRSNumber() const;
+	AnnotationView getQRSAnnotation() const;                 //consensus QRS onset, offset pairs
+	const std::vector<int>& getVotes() const;                //leads that found each consensus beat
+	AnnotationView getLeadAnnotation(int lead) const;        //QRS, peaks, P, T waves of a lead, empty if none
+	AnnotationView getLeadQRSAnnotation(int lead) const;     //QRS onset, offset pairs of a lead
+	ANN_HEADER* getAnnotationHeader();
+
+private:
+	MultiLeadAnnotator(const MultiLeadAnnotator& annotator) = delete;
+	const MultiLeadAnnotator& operator=(const MultiLeadAnnotator& annotator) = delete;
+
+	void _fuse(double sampleRate);
+
+	Annotator _annotator;                    //annotation params, ectopia of the consensus
+	double _tolerance;
+	int _votes;
+	int _threads;
+
+	std::vector<AnnotationTable> _leadAnn;
+	std::vector<AnnotationTable> _leadQrs;
+	AnnotationTable _qrsAnn;                 //consensus QRS onset, offset pairs
+	std::vector<int> _beatVotes;
+};
+
+/*//////////////////////////////////////////////
+		MultiLeadAnnotator ann;
+		if (ann.annotate(signal)) {
+			AnnotationView qrs = ann.getQRSAnnotation();      //consensus beats
+			AnnotationView lead = ann.getLeadAnnotation(0);   //P, T waves of lead 0
+		}
+//////////////////////////////////////////////*/
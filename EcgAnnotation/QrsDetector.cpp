@@ -0,0 +1,327 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "QrsDetector.h"
+#include "Annotator.h"
+#include "helper.h"
+
+QrsDetector::QrsDetector(PANN_HEADER p) : _sampleRate(0), _filtered(false), _finished(false), _blockSize(0),
+_precisionSize(0), _rawCount(0), _last(0), _skip(0), _pushed(0), _limit(0), _front(0), _size(0), _step(SKIP_START),
+_m(0), _begin(-1), _eCycle(0), _qrsCount(0), _lqNum(0)
+{
+	if (p) {
+		memcpy(&_hdr, p, sizeof(ANN_HEADER));
+	}
+	else { //Annotator defaults of the walk
+		memset(&_hdr, 0, sizeof(ANN_HEADER));
+		_hdr.minbpm = 40;       //min bpm
+		_hdr.maxbpm = 200;      //max bpm
+		_hdr.minQRS = 0.04;     //min QRS duration
+		_hdr.maxQRS = 0.2;      //max QRS duration
+		_hdr.qrsFreq = 13.0;    //QRS filtration frequency
+		_hdr.ampQRS = Annotator::INTER1;   //inter1 filter
+	}
+}
+
+const std::vector<int>& QrsDetector::getNoise() const
+{
+	return _ma;
+}
+
+const ANN_HEADER* QrsDetector::getAnnotationHeader() const
+{
+	return &_hdr;
+}
+
+int QrsDetector::getLatency() const
+{
+	if (_filtered)
+		return 0;
+	return _blockSize + _precisionSize - 2 + _fwt.getLatency();
+}
+
+bool QrsDetector::init(double sampleRate, const BeatSink &beatSink, bool filtered)
+{
+	_sampleRate = sampleRate;
+	_beatSink = beatSink;
+	_filtered = filtered;
+	_finished = false;
+
+	double eCycle = (60.0 / double(_hdr.maxbpm)) - _hdr.maxQRS;  //secs
+	if (int(eCycle*sampleRate) <= 0) {
+		eCycle = 0.1;
+		_hdr.maxbpm = int(60.0 / (_hdr.maxQRS + eCycle));
+	}
+	_eCycle = int(eCycle * sampleRate);
+
+	_pushed = 0;
+	_limit = 0;
+	_front = 0;
+	_size = 0;
+	_buffer.clear();
+	_step = SKIP_START;
+	_m = 0;
+	_begin = -1;
+	_qrsCount = 0;
+	_lqNum = 0;
+	_ma.clear();
+
+	const int J = int(ceil(log2(sampleRate / 23.0)) - 2);
+	if (filtered) {
+		_blockSize = std::max(1, int(2.0 * sampleRate));
+		return true;
+	}
+	if (J < 1)
+		return false;
+	_blockSize = std::max(1, int((2.0 * sampleRate) / pow(2.0, double(J)))) << J;     //2.0sec interval
+
+	const char* flt = (_hdr.ampQRS == Annotator::BIOR13) ? "bior13.flt" : "inter1.flt";
+	if (_fwt.init(flt, J, _blockSize) == false)
+		return false;
+	_skip = _fwt.getLatency();
+
+	_cwt.init(_blockSize, ContinuousWaveletTransform::GAUS1, 0, sampleRate);
+	_precisionSize = _cwt.GetPrecisionSize(_hdr.qrsFreq);
+	if (_precisionSize >= _blockSize)
+		return false;
+	_cwt.init(_blockSize + 2 * (_precisionSize - 1), ContinuousWaveletTransform::GAUS1, 0, sampleRate);
+
+	_raw.resize(size_t(_blockSize + 2 * (_precisionSize - 1)));
+	_rawCount = 0;
+	_block.resize(size_t(_blockSize));
+	return true;
+}
+
+void QrsDetector::close()
+{
+	_cwt.close();
+	_fwt.close();
+	std::vector<double>().swap(_raw);
+	std::vector<double>().swap(_block);
+	std::vector<double>().swap(_buffer);
+}
+
+void QrsDetector::push(const double *samples, int count)
+{
+	if (_finished || count <= 0)
+		return;
+
+	if (_filtered) {                               //in blocks, so the walk trims as it goes
+		for (int i = 0; i < count; i += _blockSize)
+			_append(samples + i, std::min(_blockSize, count - i));
+		return;
+	}
+
+	if (_pushed == 0) {                            //history before the stream start
+		for (int i = 0; i < _precisionSize - 1; i++)
+			_raw[i] = samples[0];
+		_rawCount = _precisionSize - 1;
+	}
+	_pushed += count;
+	_last = samples[count - 1];
+
+	while (count > 0) {
+		const int n = std::min(count, int(_raw.size()) - _rawCount);
+		memcpy(&_raw[_rawCount], samples, sizeof(double) * n);
+		_rawCount += n;
+		samples += n;
+		count -= n;
+		if (_rawCount == int(_raw.size()))
+			_filterBlock();
+	}
+}
+
+void QrsDetector::finish()
+{
+	if (_finished)
+		return;
+
+	if (!_filtered && _pushed > 0) {               //stream extended with its last sample
+		_limit = _pushed;
+		while (_size < _limit) {
+			for (int i = _rawCount; i < int(_raw.size()); i++)
+				_raw[i] = _last;
+			_rawCount = int(_raw.size());
+			_filterBlock();
+		}
+	}
+
+	_finished = true;
+	_walk();
+}
+
+//cwt of the window, samples of the block only use the window. then fwt 0-30Hz removal as in
+//Annotator::_filter30Hz with the hf thresholds over one block, 2 sec
+void QrsDetector::_filterBlock()
+{
+	const double *pSpec = _cwt.Transform(_raw.data(), _hdr.qrsFreq);
+	double *data = _block.data();
+	for (int i = 0; i < _blockSize; i++)
+		data[i] = pSpec[i + _precisionSize - 1];
+
+	const int history = 2 * (_precisionSize - 1);        //next window starts a block later
+	memmove(_raw.data(), &_raw[_blockSize], sizeof(double) * history);
+	_rawCount = history;
+
+	if (_hdr.ampQRS == Annotator::BIOR13) {
+		for (int i = 0; i < _blockSize; i++)  //ridges
+			data[i] *= (fabs(data[i]) / 2.0);
+	}
+
+	const int J = _fwt.getJ();
+	_fwt.analysis(data);
+	for (int j = J; j > 0; j--) {
+		const int window = int((2.0 * _sampleRate) / pow(2.0, double(j)));    //2.0sec interval
+		denoise(_fwt.GetDetail(j), _blockSize >> j, window, 0, false);  //hard,MINIMAX denoise [30-...Hz]
+	}
+	double *lo = _fwt.GetApproximation();
+	for (int i = 0; i < (_blockSize >> J); i++)   //remove [0-30Hz]
+		lo[i] = 0.0;
+	_fwt.synthesis(data);
+
+	const int skip = std::min(_skip, _blockSize);
+	_skip -= skip;
+	int count = _blockSize - skip;
+	if (_limit > 0)
+		count = std::min(count, _limit - _size);
+	_append(data + skip, count);
+}
+
+void QrsDetector::_append(const double *filtered, int count)
+{
+	_buffer.insert(_buffer.end(), filtered, filtered + count);
+	_size += count;
+	if (!_finished)
+		_walk();
+	_trim();
+}
+
+//samples before the onset of the QRS walked, or before the walk position, are not read again
+void QrsDetector::_trim()
+{
+	int keep = (_begin >= 0) ? std::min(_begin, _m) : _m;
+	keep = std::min(keep - _front, int(_buffer.size()));
+	if (keep > _blockSize) {
+		_buffer.erase(_buffer.begin(), _buffer.begin() + keep);
+		_front += keep;
+	}
+}
+
+bool QrsDetector::_isNoise(int n) const
+{
+	for (int i = n; i < n + _eCycle; i++)
+		if (fabs(_at(i)) > FLOAT_EQ_ERR) return true;
+
+	return false;
+}
+
+//the getQRS walk: MAX 200bpm, QRS of maxQRS then eCycle at least to the next one. Runs until a
+//step needs filtered samples not there yet; steps depending on the stream size wait for finish()
+void QrsDetector::_walk()
+{
+	const int qrsLength = int(_hdr.maxQRS * _sampleRate);
+	const int half = int(_sampleRate / 2);
+	const int size = _size;
+
+	while (true) {
+		switch (_step) {
+		case SKIP_START:                                   //skip QRS in begining
+			while (_m < size && fabs(_at(_m)) > FLOAT_EQ_ERR)
+				_m += int(0.1 * _sampleRate);
+			if (_m >= size) {
+				if (_finished) _step = DONE;
+				return;
+			}
+			_step = FIND_START;
+			break;
+
+		case FIND_START:                                   //get 1st QRS
+			while (_m < size && fabs(_at(_m)) < FLOAT_EQ_ERR)
+				_m++;
+			if (_m >= size) {
+				if (_finished) _step = DONE;
+				return;
+			}
+			_begin = _m - 1;
+			_step = QRS_END;
+			break;
+
+		case QRS_END: {                                    //smpl + 0,20sec    [0,20 max QRS length]
+			int m = _m + qrsLength;
+			if (!_finished && m + _eCycle >= size)
+				return;
+			if (m >= size) m = size - 1;
+
+			if (m + _eCycle >= size) {                     //near end of signal
+				_begin = -1;
+				_step = DONE;
+				return;
+			}
+			if (_isNoise(m)) {                             //smp(0.10sec)+0,20sec in noise
+				if (_lqNum != _qrsCount)
+					_ma.push_back(_begin);                 //push MA noise location
+				_begin = -1;
+				_lqNum = _qrsCount;
+				_m = m;
+				_step = NOISE;
+				break;
+			}
+
+			int add = 0;
+			while (m - add > _front && _at(m - add) == 0.0) add++;   //Find back for QRS end
+
+			if ((m - add + 1) - _begin > _hdr.minQRS*_sampleRate) {  //QRS size > 0.04 sec
+				_qrsCount += 2;
+				_beatSink(_begin, m - add + 2);            //QRS end
+			}
+			_begin = -1;
+
+			_m = m + _eCycle;                              //smpl + [0,20+0,10]sec    200bpm MAX
+			_step = QRS_BEGIN;
+			break;
+		}
+
+		case NOISE:                                        //Find for next possible QRS start
+			while (true) {
+				if (!_finished && _m + _eCycle >= size)
+					return;
+				if (_m + _eCycle >= size) {                //end of signal
+					_step = DONE;
+					return;
+				}
+				if (!_isNoise(_m))
+					break;
+				_m += _eCycle;
+			}
+			_step = NOISE_END;
+			break;
+
+		case NOISE_END:
+			while (_m < size && _at(_m) > FLOAT_EQ_ERR)
+				_m++;
+			if (_m >= size) {
+				if (_finished) _step = DONE;
+				return;
+			}
+			_begin = _m - 1;
+			_m++;
+			_step = QRS_END;
+			break;
+
+		case QRS_BEGIN:                                    //Find nearest QRS
+			while (_m + half <= size && fabs(_at(_m)) < FLOAT_EQ_ERR)
+				_m++;
+			if (_m + half > size) {                        //end of data
+				if (_finished) _step = DONE;
+				return;
+			}
+			_begin = _m - 1;                               //QRS begin
+			_m++;
+			_step = QRS_END;
+			break;
+
+		case DONE:
+			return;
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "ecgtypes.h"
+#include "ContinuousWaveletTransform.h"
+#include "StreamingWaveletTransform.h"
+
+//push based QRS detection of Annotator::getQRS: pushed samples go through the same qrsFreq CWT and
+//0-30 Hz FWT removal block by block, and the same walk with its eCycle and noise rules hands QRS
+//onset, offset pairs to the beat sink once they can no longer change. A beat is reported at most
+//getLatency() samples plus max(0.5, 60 / maxbpm) sec after its offset was pushed, and memory is
+//bounded by the filter blocks and one step of the walk, whatever the length of the stream.
+//The filtered stream differs from that of the whole record at its ends, which are extended with
+//the first and last samples, and by the 2 sec threshold windows, which start at the stream start
+class QrsDetector
+{
+public:
+	QrsDetector(PANN_HEADER p = nullptr);
+
+	// Data
+	typedef std::function<void(int onset, int offset)> BeatSink;     //stream sample indices
+
+	// Operations
+	//filtered: samples are already filtered as by Annotator::_filter30Hz, only the walk runs
+	bool init(double sampleRate, const BeatSink &beatSink, bool filtered = false);
+	void close();
+
+	void push(const double *samples, int count);
+	void finish();                                 //end of stream, settles the beats left
+
+	// Access
+	const std::vector<int>& getNoise() const;      //MA noise locations
+	int getLatency() const;                        //samples pushed after a sample before it is walked
+	const ANN_HEADER* getAnnotationHeader() const; //maxbpm lowered if 60/maxbpm - maxQRS is below a sample
+
+private:
+	QrsDetector(const QrsDetector& detector) = delete;
+	const QrsDetector& operator=(const QrsDetector& detector) = delete;
+
+	enum STEP { SKIP_START, FIND_START, QRS_END, NOISE, NOISE_END, QRS_BEGIN, DONE };
+
+	void _filterBlock();                           //_raw window to a block of filtered samples
+	void _append(const double *filtered, int count);
+	void _walk();
+	void _trim();
+	inline double _at(int n) const;
+	bool _isNoise(int n) const;
+
+	ANN_HEADER _hdr;
+	BeatSink _beatSink;
+	double _sampleRate;
+	bool _filtered;
+	bool _finished;
+
+	//filtering
+	ContinuousWaveletTransform _cwt;
+	StreamingWaveletTransform _fwt;
+	int _blockSize;            //2 sec, multiple of 2^J
+	int _precisionSize;        //cwt taps on either side of a sample + 1
+	std::vector<double> _raw;  //[precisionSize-1 history | block | precisionSize-1 ahead]
+	int _rawCount;
+	double _last;              //last sample pushed
+	std::vector<double> _block;
+	int _skip;                 //synthesized samples before the stream start
+	int _pushed;
+	int _limit;                //filtered samples of the stream once finished
+
+	//walk over filtered samples [_front, _size)
+	std::vector<double> _buffer;
+	int _front;
+	int _size;
+	enum STEP _step;
+	int _m;
+	int _begin;                //onset of the QRS walked, -1 none
+	int _eCycle;               //samples
+	int _qrsCount;             //onsets and offsets reported
+	int _lqNum;
+	std::vector<int> _ma;      //MA noise
+};
+
+/*//////////////////////////////////////////////
+		QrsDetector detector;
+		detector.init(SR, [](int onset, int offset) { ... });
+		while (read samples)
+			detector.push(samples, count);
+		detector.finish();
+//////////////////////////////////////////////*/
+
+// Inlines
+inline double QrsDetector::_at(int n) const
+{
+	return _buffer[size_t(n - _front)];
+}
@@ -0,0 +1,229 @@
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64
+#endif
+#include <math.h>
+#include <string.h>
+#include "ScalogramFile.h"
+#include "ContinuousWaveletTransform.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+ScalogramFile::ScalogramFile() : _lpMap(nullptr), _mapLength(0),
+#ifdef _WIN32
+                                 _fp(INVALID_HANDLE_VALUE), _fpmap(nullptr),
+#else
+                                 _fd(-1),
+#endif
+                                 _pHDR(nullptr), _lpf(nullptr), _rows(0), _size(0), _writable(false)
+{
+}
+
+ScalogramFile::~ScalogramFile()
+{
+	Close();
+}
+
+bool ScalogramFile::Create(const char *name, const ContinuousWaveletTransformBase &cwt, int size, double sr)
+{
+	CWT_HEADER hdr;
+	memset(&hdr, 0, sizeof(CWT_HEADER));
+	memcpy(hdr.hdr, "WLET", 4);
+	hdr.fmin = float(cwt.GetMinFreq());
+	hdr.fmax = float(cwt.GetMaxFreq());
+	hdr.fstep = float(cwt.GetFreqInterval());
+	hdr.size = (unsigned int)size;
+	hdr.sr = float(sr);
+	hdr.type = (unsigned char)cwt.GetScaleType();
+
+	return Create(name, hdr, cwt.GetFreqRange());
+}
+
+bool ScalogramFile::Create(const char *name, const CWT_HEADER &hdr, int rows)
+{
+	Close();
+	if (rows <= 0 || hdr.size == 0)
+		return false;
+
+	const size_t length = sizeof(CWT_HEADER) + sizeof(float) * size_t(rows) * hdr.size;
+	if (!_map(name, length, true, true))
+		return false;
+
+	memcpy(_lpMap, &hdr, sizeof(CWT_HEADER));          //rows are zero filled by the new file
+	memcpy(_pHDR->hdr, "WLET", 4);
+	_rows = rows;
+	_size = int(hdr.size);
+	return true;
+}
+
+bool ScalogramFile::Open(const char *name, bool writable)
+{
+	Close();
+	if (!_map(name, 0, false, writable))
+		return false;
+
+	if (_mapLength < sizeof(CWT_HEADER) || memcmp(_pHDR->hdr, "WLET", 4) || _pHDR->size == 0) {
+		Close();
+		return false;
+	}
+
+	//rows from the file length, legacy files rounded the row count up
+	_size = int(_pHDR->size);
+	_rows = int((_mapLength - sizeof(CWT_HEADER)) / (sizeof(float) * _pHDR->size));
+	return true;
+}
+
+bool ScalogramFile::_map(const char *name, size_t length, bool create, bool writable)
+{
+#ifdef _WIN32
+	_fp = CreateFileA(name, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, writable ? 0 : FILE_SHARE_READ, 0,
+	                  create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (_fp == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!create) {
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(_fp, &fileSize) || fileSize.QuadPart == 0) {
+			Close();
+			return false;
+		}
+		length = size_t(fileSize.QuadPart);
+	}
+
+	const unsigned long long mapSize = length;
+	_fpmap = CreateFileMapping(_fp, 0, writable ? PAGE_READWRITE : PAGE_READONLY, DWORD(mapSize >> 32), DWORD(mapSize), 0);
+	if (!_fpmap) {
+		Close();
+		return false;
+	}
+	_lpMap = MapViewOfFile(_fpmap, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length);
+#else
+	_fd = open(name, create ? O_RDWR | O_CREAT | O_TRUNC : (writable ? O_RDWR : O_RDONLY), 0644);
+	if (_fd < 0)
+		return false;
+
+	if (create) {
+		if (ftruncate(_fd, off_t(length))) {              //sparse file, nothing held in memory
+			Close();
+			return false;
+		}
+	}
+	else {
+		struct stat st;
+		if (fstat(_fd, &st) || st.st_size == 0) {
+			Close();
+			return false;
+		}
+		length = size_t(st.st_size);
+	}
+
+	_lpMap = mmap(0, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, _fd, 0);
+	if (_lpMap == MAP_FAILED)
+		_lpMap = nullptr;
+#endif
+	if (!_lpMap) {
+		Close();
+		return false;
+	}
+
+	_mapLength = length;
+	_writable = writable;
+	_pHDR = static_cast<PCWT_HEADER>(_lpMap);
+	_lpf = reinterpret_cast<float *>(static_cast<char *>(_lpMap) + sizeof(CWT_HEADER));
+	return true;
+}
+
+void ScalogramFile::Flush()
+{
+	if (!_lpMap || !_writable)
+		return;
+#ifdef _WIN32
+	FlushViewOfFile(_lpMap, 0);
+#else
+	msync(_lpMap, _mapLength, MS_ASYNC);
+#endif
+}
+
+void ScalogramFile::Close()
+{
+#ifdef _WIN32
+	if (_lpMap)
+		UnmapViewOfFile(_lpMap);
+	if (_fpmap)
+		CloseHandle(_fpmap);
+	if (_fp != INVALID_HANDLE_VALUE)
+		CloseHandle(_fp);
+	_fpmap = nullptr;
+	_fp = INVALID_HANDLE_VALUE;
+#else
+	if (_lpMap)
+		munmap(_lpMap, _mapLength);
+	if (_fd >= 0)
+		close(_fd);
+	_fd = -1;
+#endif
+	_lpMap = nullptr;
+	_mapLength = 0;
+	_pHDR = nullptr;
+	_lpf = nullptr;
+	_rows = 0;
+	_size = 0;
+	_writable = false;
+}
+
+bool ScalogramFile::WriteRow(int row, const double *spectrum)
+{
+	if (!_writable || row < 0 || row >= _rows)
+		return false;
+
+	float *pRow = _lpf + size_t(row) * _size;
+	for (int i = 0; i < _size; i++)
+		pRow[i] = float(spectrum[i]);
+	return true;
+}
+
+bool ScalogramFile::WriteRow(int row, const float *spectrum)
+{
+	if (!_writable || row < 0 || row >= _rows)
+		return false;
+
+	memcpy(_lpf + size_t(row) * _size, spectrum, sizeof(float) * _size);
+	return true;
+}
+
+const float* ScalogramFile::GetRow(int row) const
+{
+	if (row < 0 || row >= _rows)
+		return nullptr;
+	return _lpf + size_t(row) * _size;
+}
+
+bool ScalogramFile::ReadColumn(int column, float *out) const
+{
+	if (column < 0 || column >= _size)
+		return false;
+
+	const float *p = _lpf + column;
+	for (int row = 0; row < _rows; row++, p += _size)
+		out[row] = *p;
+	return true;
+}
+
+float ScalogramFile::GetValue(int row, int column) const
+{
+	return _lpf[size_t(row) * _size + column];
+}
+
+double ScalogramFile::GetFrequency(int row) const
+{
+	if (_pHDR->type == ContinuousWaveletTransformBase::LOG_SCALE)
+		return exp(log(double(_pHDR->fmin)) + row * double(_pHDR->fstep));
+	return _pHDR->fmin + row * double(_pHDR->fstep);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include "ecgtypes.h"
+
+class ContinuousWaveletTransformBase;
+
+//"WLET" scalogram file: CWT_HEADER followed by rows x size float32 values, one row per frequency
+//the file is memory mapped, so rows are paged in and out on access and files larger than RAM
+//can be written row by row and read by row or column
+class ScalogramFile
+{
+public:
+	ScalogramFile();
+	~ScalogramFile();
+
+	// Operations
+	bool Create(const char *name, const ContinuousWaveletTransformBase &cwt, int size, double sr);   //frequency grid of cwt
+	bool Create(const char *name, const CWT_HEADER &hdr, int rows);
+	bool Open(const char *name, bool writable = false);
+	void Flush();                                    //schedule dirty rows for writeback
+	void Close();
+
+	bool WriteRow(int row, const double *spectrum);  //safe from several threads for different rows
+	bool WriteRow(int row, const float *spectrum);
+	const float* GetRow(int row) const;
+	bool ReadColumn(int column, float *out) const;   //GetRows() values of one sample
+	float GetValue(int row, int column) const;
+
+	// Access
+	const CWT_HEADER* GetHeader() const { return _pHDR; }
+	int GetRows() const { return _rows; }
+	int GetSize() const { return _size; }
+	double GetFrequency(int row) const;
+
+private:
+	ScalogramFile(const ScalogramFile& file) = delete;
+	const ScalogramFile& operator=(const ScalogramFile& file) = delete;
+
+	bool _map(const char *name, size_t length, bool create, bool writable);
+
+	void *_lpMap;
+	size_t _mapLength;
+#ifdef _WIN32
+	void *_fp;
+	void *_fpmap;
+#else
+	int _fd;
+#endif
+
+	PCWT_HEADER _pHDR;
+	float *_lpf;                                     //first row, after the header
+	int _rows;
+	int _size;
+	bool _writable;
+};
@@ -0,0 +1,273 @@
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "StationaryWaveletTransform.h"
+#include "vectorops.h"
+#include "waveletfilters.h"
+
+#define SWT_BLOCK 256                     //outputs per tap pass, block accumulators stay in L1
+#define SWT_TASK 8192                     //outputs per thread task
+
+template <typename T>
+StationaryWaveletTransformT<T>::StationaryWaveletTransformT() : _j(0), _signalSize(0), _margin(0), _bandSize(0), _levels(0),
+_pBands(nullptr), _bandsCapacity(0), _pExtension(nullptr), _extensionCapacity(0)
+{
+}
+
+template <typename T>
+StationaryWaveletTransformT<T>::~StationaryWaveletTransformT()
+{
+	if (_pBands) free(_pBands);
+	if (_pExtension) free(_pExtension);
+}
+
+template <typename T>
+bool StationaryWaveletTransformT<T>::init(const T* data, int size, const char* filterName)
+{
+	return init(data, size, 0, CONSTANT_EXTENSION, filterName);
+}
+
+template <typename T>
+bool StationaryWaveletTransformT<T>::init(const T* data, int size, int pad, enum EXTENSION extension, const char* filterName)
+{
+	bool builtIn;
+	const WAVELET_FILTER *filter = _findFilter(filterName, builtIn);
+	if (!filter || size < 1)
+		return false;
+
+	Filter *filters[4] = { &_tH, &_tG, &_h, &_g };
+	const double *taps = filter->taps;
+	for (int f = 0; f < 4; f++) {
+		filters[f]->taps.assign(taps, taps + filter->length[f]);
+		filters[f]->center = filter->center[f];
+		taps += filter->length[f];
+	}
+
+	_signalSize = size + 2 * pad;
+	_bandSize = _signalSize;
+	_margin = 0;
+	_levels = 0;
+	_j = 0;
+	if (size_t(_signalSize) > _bandsCapacity) {             //kept at the high-water mark until close()
+		if (_pBands) free(_pBands);
+		_pBands = static_cast<T *>(malloc(sizeof(T) * _signalSize));
+		_bandsCapacity = _signalSize;
+	}
+	_padSignal(data, size, pad, extension, _pBands);
+
+	return true;
+}
+
+template <typename T>
+void StationaryWaveletTransformT<T>::close()
+{
+	if (_pBands) {
+		free(_pBands);
+		_pBands = nullptr;
+	}
+	_bandsCapacity = 0;
+	if (_pExtension) {
+		free(_pExtension);
+		_pExtension = nullptr;
+	}
+	_extensionCapacity = 0;
+	_margin = 0;
+	_bandSize = _signalSize;
+	_levels = 0;
+	_j = 0;
+}
+
+
+//////////////////////transforms///////////////////////////////////////////////////////////////////
+//whole sample symmetric extension folded as often as the dilated filters need
+static inline int reflectIndex(int n, int size)
+{
+	if (size == 1)
+		return 0;
+	const int period = 2 * size - 2;
+	n %= period;
+	if (n < 0) n += period;
+	return n < size ? n : period - n;
+}
+
+template <typename T>
+static int filterReach(const T &filter)
+{
+	return std::max(filter.center, int(filter.taps.size()) - 1 - filter.center);
+}
+
+//bands for levels with margins covering the analysis of all levels from the margin of the
+//approximation and their synthesis back to [0, size): (2^levels - 1) * (analysis + synthesis reach)
+template <typename T>
+void StationaryWaveletTransformT<T>::_allocate(int levels)
+{
+	const int reach = std::max(filterReach(_tH), filterReach(_tG)) + std::max(filterReach(_h), filterReach(_g));
+	const int margin = std::max(_margin, ((1 << levels) - 1) * reach);
+	const int bandSize = _signalSize + 2 * margin;
+	const size_t capacity = (size_t(levels) + 1) * bandSize;
+
+	if (_j == 0 && capacity <= _bandsCapacity) {      //signal moved to its margin in place
+		T *to = _pBands + margin;
+		memmove(to - _margin, _pBands, sizeof(T) * _bandSize);
+		for (int n = -margin; n < -_margin; n++)
+			to[n] = to[reflectIndex(n, _signalSize)];
+		for (int n = _signalSize + _margin; n < _signalSize + margin; n++)
+			to[n] = to[reflectIndex(n, _signalSize)];
+	}
+	else {
+		T *bands = static_cast<T *>(malloc(sizeof(T) * capacity));
+		for (int b = 0; b <= _j; b++) {               //computed bands, new margins from [0, size)
+			const T *from = _pBands + size_t(b) * _bandSize + _margin;
+			T *to = bands + size_t(b) * bandSize + margin;
+			for (int n = -margin; n < _signalSize + margin; n++)
+				to[n] = (n >= -_margin && n < _signalSize + _margin) ? from[n] : from[reflectIndex(n, _signalSize)];
+		}
+		free(_pBands);
+		_pBands = bands;
+		_bandsCapacity = capacity;
+	}
+	_margin = margin;
+	_bandSize = bandSize;
+	_levels = levels;
+}
+
+template <typename T>
+T* StationaryWaveletTransformT<T>::_extend(const T *band, int reach, int slot)
+{
+	const int length = _bandSize + 2 * reach;
+	if (2 * length > _extensionCapacity) {
+		if (_pExtension) free(_pExtension);
+		_pExtension = static_cast<T *>(malloc(sizeof(T) * 2 * length));
+		_extensionCapacity = 2 * length;
+	}
+
+	T *ext = _pExtension + slot * length + reach;
+	memcpy(ext, band, sizeof(T) * _bandSize);
+	for (int k = 1; k <= reach; k++) {
+		ext[-k] = band[reflectIndex(-k, _bandSize)];
+		ext[_bandSize - 1 + k] = band[reflectIndex(_bandSize - 1 + k, _bandSize)];
+	}
+	return ext;
+}
+
+//block(from, count) over the _bandSize samples of a band in SWT_TASK pieces, shared by the threads
+template <typename T>
+template <typename F>
+void StationaryWaveletTransformT<T>::_forBlocks(int threads, const F &block) const
+{
+	const int tasks = (_bandSize + SWT_TASK - 1) / SWT_TASK;
+	if (threads <= 0)
+		threads = int(std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, tasks));
+
+	std::atomic<int> next(0);
+	auto worker = [&]() {
+		for (int task = next++; task < tasks; task = next++) {
+			const int from = task * SWT_TASK;
+			block(from, std::min(SWT_TASK, _bandSize - from));
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < threads; i++)
+		pool.emplace_back(worker);
+	worker();
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+}
+
+//a[n] = sum tH[m] a[n + 2^j m], d[n] = sum tG[m] a[n + 2^j m], one vector pass per tap
+template <typename T>
+void StationaryWaveletTransformT<T>::_transformLevel(int threads)
+{
+	const int dilation = 1 << _j;
+	const T *a = _extend(_pBands, dilation * std::max(filterReach(_tH), filterReach(_tG)), 0);
+	T *approximation = _pBands;
+	T *detail = _pBands + size_t(_j + 1) * _bandSize;
+
+	_forBlocks(threads, [&](int from, int count) {
+		T s[SWT_BLOCK];
+		T d[SWT_BLOCK];
+		for (int n0 = from; n0 < from + count; n0 += SWT_BLOCK) {
+			const int size = std::min(SWT_BLOCK, from + count - n0);
+			memset(s, 0, sizeof(T) * size);
+			memset(d, 0, sizeof(T) * size);
+
+			for (int i = 0; i < int(_tH.taps.size()); i++) {
+				if (_tH.taps[i] != 0)
+					Axpy(_tH.taps[i], a + n0 + dilation * (i - _tH.center), size, s);
+			}
+			for (int i = 0; i < int(_tG.taps.size()); i++) {
+				if (_tG.taps[i] != 0)
+					Axpy(_tG.taps[i], a + n0 + dilation * (i - _tG.center), size, d);
+			}
+
+			memcpy(approximation + n0, s, sizeof(T) * size);
+			memcpy(detail + n0, d, sizeof(T) * size);
+		}
+	});
+}
+
+//a[n] = sum h[m] a'[n - 2^j m] + sum g[m] d[n - 2^j m], the mean of the decimated syntheses
+//of the even and odd coefficient phases
+template <typename T>
+void StationaryWaveletTransformT<T>::_synthesisLevel(int threads)
+{
+	const int dilation = 1 << (_j - 1);
+	const int reach = dilation * std::max(filterReach(_h), filterReach(_g));
+	const T *a = _extend(_pBands, reach, 0);
+	const T *d = _extend(_pBands + size_t(_j) * _bandSize, reach, 1);
+	T *approximation = _pBands;
+
+	_forBlocks(threads, [&](int from, int count) {
+		T s[SWT_BLOCK];
+		for (int n0 = from; n0 < from + count; n0 += SWT_BLOCK) {
+			const int size = std::min(SWT_BLOCK, from + count - n0);
+			memset(s, 0, sizeof(T) * size);
+
+			for (int i = 0; i < int(_h.taps.size()); i++) {
+				if (_h.taps[i] != 0)
+					Axpy(_h.taps[i], a + n0 - dilation * (i - _h.center), size, s);
+			}
+			for (int i = 0; i < int(_g.taps.size()); i++) {
+				if (_g.taps[i] != 0)
+					Axpy(_g.taps[i], d + n0 - dilation * (i - _g.center), size, s);
+			}
+
+			memcpy(approximation + n0, s, sizeof(T) * size);
+		}
+	});
+}
+
+template <typename T>
+void StationaryWaveletTransformT<T>::transform(int scales, int threads)
+{
+	if (!_pBands || scales <= 0)
+		return;
+
+	if (_j + scales > _levels)
+		_allocate(_j + scales);
+
+	for (int j = 0; j < scales; j++) {
+		_transformLevel(threads);
+		_j++;
+	}
+}
+
+template <typename T>
+void StationaryWaveletTransformT<T>::synthesis(int scales, int threads)
+{
+	if (!_pBands)
+		return;
+
+	for (int j = 0; j < scales && _j > 0; j++) {
+		_synthesisLevel(threads);
+		_j--;
+	}
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+template class StationaryWaveletTransformT<double>;
+template class StationaryWaveletTransformT<float>;
@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include "FastWaveletTransform.h"
+
+//undecimated (a trous) wavelet transform with the FastWaveletTransform filters: every level keeps
+//size samples and level j filters are dilated by 2^j, so coefficients of a shifted signal are the
+//shifted coefficients and chunks of a record give the same values as the whole record away from
+//the chunk edges. Bands are the transform of the symmetric extension of the signal over
+//[-getMargin(), size + getMargin()), so synthesis is exact up to the edges. Changes to a band
+//(thresholds, zeroed approximation) should cover the margins too.
+//The margin is sized by the first transform() from level 0; more levels added by a later call
+//get symmetrically extended margins and approximate edges. (levels + 1) * (size + 2 margin) memory
+template <typename T>
+class StationaryWaveletTransformT : public FastWaveletTransformBase
+{
+public:
+	StationaryWaveletTransformT();
+	~StationaryWaveletTransformT();
+
+	// Operations
+	bool init(const T* data, int size, const char* filter);
+	bool init(const T* data, int size, int pad, enum EXTENSION extension, const char* filter);   //size + 2 pad samples
+	void close();
+
+	void transform(int scales, int threads = 0);         //threads 0 = all cores
+	void synthesis(int scales, int threads = 0);
+
+	// Access
+	inline T* GetApproximation() const;              //lowpass band of the current level, sample 0
+	inline T* GetDetail(int j) const;                //highpass band of level j = 1 (finest) .. getJ()
+	inline int getSize() const;
+	inline int getMargin() const;                    //band samples before 0 and after size - 1
+	inline int getJ() const;
+
+private:
+	StationaryWaveletTransformT(const StationaryWaveletTransformT& swt) = delete;
+	const StationaryWaveletTransformT& operator=(const StationaryWaveletTransformT& swt) = delete;
+
+	struct Filter {
+		std::vector<T> taps;
+		int center;
+	};
+
+	void _transformLevel(int threads);              //approximation to approximation and detail _j + 1
+	void _synthesisLevel(int threads);              //approximation and detail _j to approximation
+	void _allocate(int levels);
+	T* _extend(const T *band, int reach, int slot); //band with reach more samples at both ends
+	template <typename F> void _forBlocks(int threads, const F &block) const;
+
+	Filter _tH, _tG;           //analysis filters
+	Filter _h, _g;             //synth filters
+
+	int _j;                    //levels
+	int _signalSize;
+	int _margin;
+	int _bandSize;             //_signalSize + 2 * _margin
+	int _levels;               //bands allocated in _pBands
+
+	T *_pBands;                //approximation, then details of levels 1.._levels, _bandSize samples each
+	size_t _bandsCapacity;     //kept between init() calls, see FastWaveletTransformT::init()
+	T *_pExtension;            //two mirror extended bands of the level
+	int _extensionCapacity;
+};
+
+typedef StationaryWaveletTransformT<double> StationaryWaveletTransform;
+typedef StationaryWaveletTransformT<float> StationaryWaveletTransformF;
+
+// Inlines
+template <typename T>
+inline T* StationaryWaveletTransformT<T>::GetApproximation() const
+{
+	return _pBands + _margin;
+}
+
+template <typename T>
+inline T* StationaryWaveletTransformT<T>::GetDetail(int j) const
+{
+	return _pBands + size_t(j) * _bandSize + _margin;
+}
+
+template <typename T>
+inline int StationaryWaveletTransformT<T>::getSize() const
+{
+	return _signalSize;
+}
+
+template <typename T>
+inline int StationaryWaveletTransformT<T>::getMargin() const
+{
+	return _margin;
+}
+
+template <typename T>
+inline int StationaryWaveletTransformT<T>::getJ() const
+{
+	return _j;
+}
@@ -0,0 +1,230 @@
+#include <string.h>
+#include <algorithm>
+#include "StreamingWaveletTransform.h"
+#include "vectorops.h"
+#include "waveletfilters.h"
+
+template <typename T>
+StreamingWaveletTransformT<T>::StreamingWaveletTransformT() : _analysisBack(0), _analysisForward(0),
+_synthesisBack(0), _synthesisForward(0), _j(0), _blockSize(0), _analysisStarted(false), _synthesisStarted(false)
+{
+}
+
+//analysis: lo[k] = sum tH[m + Z] x[2k + m], back/forward = samples of x before/after 2k
+//synthesis: x[2k], x[2k + 1] = 2 sum h[2m + Z], h[2m + 1 + Z] lo[k - m], coefficients before/after k
+template <typename T>
+void StreamingWaveletTransformT<T>::_reach(const Filter &filter, bool synthesis, int &back, int &forward)
+{
+	const int length = int(filter.taps.size());
+	if (!synthesis) {
+		back = std::max(back, filter.center);
+		forward = std::max(forward, length - 1 - filter.center);
+		return;
+	}
+	for (int m = -filter.center; m < length - filter.center; m++) {
+		if ((2 * m + filter.center >= 0 && 2 * m + filter.center < length) ||
+		    (2 * m + 1 + filter.center >= 0 && 2 * m + 1 + filter.center < length)) {
+			back = std::max(back, m);
+			forward = std::max(forward, -m);
+		}
+	}
+}
+
+template <typename T>
+bool StreamingWaveletTransformT<T>::init(const char* filterName, int scales, int blockSize)
+{
+	bool builtIn;
+	const WAVELET_FILTER *filter = _findFilter(filterName, builtIn);
+	if (!filter || scales < 1 || blockSize < (2 << (scales - 1)) || blockSize % (1 << scales))
+		return false;
+
+	close();
+
+	Filter *filters[4] = { &_tH, &_tG, &_h, &_g };
+	const double *taps = filter->taps;
+	for (int f = 0; f < 4; f++) {
+		filters[f]->taps.assign(taps, taps + filter->length[f]);
+		filters[f]->center = filter->center[f];
+		taps += filter->length[f];
+	}
+
+	_reach(_tH, false, _analysisBack, _analysisForward);
+	_reach(_tG, false, _analysisBack, _analysisForward);
+	_reach(_h, true, _synthesisBack, _synthesisForward);
+	_reach(_g, true, _synthesisBack, _synthesisForward);
+	const int synthesisHistory = _synthesisBack + _synthesisForward;
+
+	_j = scales;
+	_blockSize = blockSize;
+	_levels.resize(scales);
+
+	//analysis: level input starts at index start, outputs 2k from start - delay with an even delay
+	//covering the forward reach, so the next level starts at (start - delay) / 2
+	int start = 0;
+	for (int j = 0; j < scales; j++) {
+		Level &level = _levels[j];
+		const int delay = _analysisForward + ((start - _analysisForward) & 1);
+		level.size = blockSize >> j;
+		level.bandStart = (start - delay) / 2;
+		level.analysisHistory = delay + _analysisBack;
+		level.input.assign(level.analysisHistory + level.size, 0);
+		level.lo.assign(level.size / 2, 0);
+		level.hi.assign(level.size / 2, 0);
+		start = level.bandStart;
+	}
+
+	//synthesis: from the deepest level up, x[2k] of a level from 2 (loStart - forward), details
+	//are held back until the approximation synthesized from the deeper levels catches up
+	int loStart = _levels[scales - 1].bandStart;
+	for (int j = scales - 1; j >= 0; j--) {
+		Level &level = _levels[j];
+		level.loStart = loStart;
+		level.hiDelay = level.bandStart - loStart;
+		level.loHistory.assign(synthesisHistory + level.size / 2, 0);
+		level.hiHistory.assign(synthesisHistory + level.size / 2 + level.hiDelay, 0);
+		level.output.assign(level.size, 0);
+		loStart = 2 * (loStart - _synthesisForward);
+	}
+
+	_even.assign(blockSize / 2 + std::max(_levels[0].analysisHistory, synthesisHistory), 0);
+	_odd.assign(_even.size(), 0);
+	return true;
+}
+
+template <typename T>
+void StreamingWaveletTransformT<T>::close()
+{
+	_levels.clear();
+	_even.clear();
+	_odd.clear();
+	_analysisBack = _analysisForward = 0;
+	_synthesisBack = _synthesisForward = 0;
+	_j = 0;
+	_blockSize = 0;
+	_analysisStarted = false;
+	_synthesisStarted = false;
+}
+
+template <typename T>
+int StreamingWaveletTransformT<T>::getDetailDelay(int j) const
+{
+	return -_levels[j - 1].bandStart;
+}
+
+template <typename T>
+int StreamingWaveletTransformT<T>::getLatency() const
+{
+	return -2 * (_levels[0].loStart - _synthesisForward);
+}
+
+
+//////////////////////streaming/////////////////////////////////////////////////////////////////
+//input buffer [analysisHistory | block]: lo[t] = sum tH[m + Z] input[back + 2t + m]
+template <typename T>
+void StreamingWaveletTransformT<T>::_analysisLevel(Level &level, const T *block)
+{
+	T *input = level.input.data();
+	const int history = level.analysisHistory;
+	const int total = history + level.size;
+	const int half = level.size / 2;
+
+	if (!_analysisStarted) {
+		for (int i = 0; i < history; i++)
+			input[i] = block[0];
+	}
+	memcpy(input + history, block, sizeof(T) * level.size);
+
+	for (int i = 0; 2 * i < total; i++) {
+		_even[i] = input[2 * i];
+		if (2 * i + 1 < total)
+			_odd[i] = input[2 * i + 1];
+	}
+	const T *channel[2] = { _even.data(), _odd.data() };
+
+	memset(level.lo.data(), 0, sizeof(T) * half);
+	memset(level.hi.data(), 0, sizeof(T) * half);
+	for (int m = -_tH.center; m < int(_tH.taps.size()) - _tH.center; m++) {
+		const int n = _analysisBack + m;
+		Axpy(_tH.taps[m + _tH.center], channel[n & 1] + (n >> 1), half, level.lo.data());
+	}
+	for (int m = -_tG.center; m < int(_tG.taps.size()) - _tG.center; m++) {
+		const int n = _analysisBack + m;
+		Axpy(_tG.taps[m + _tG.center], channel[n & 1] + (n >> 1), half, level.hi.data());
+	}
+
+	memmove(input, input + level.size, sizeof(T) * history);
+}
+
+//lo and hi windows [history | block] of the same coefficients: output pair t from k = back + t
+template <typename T>
+void StreamingWaveletTransformT<T>::_synthesisLevel(Level &level, const T *lo)
+{
+	const int history = _synthesisBack + _synthesisForward;
+	const int half = level.size / 2;
+	T *loWindow = level.loHistory.data();
+	T *hiWindow = level.hiHistory.data();
+
+	if (!_synthesisStarted) {
+		for (int i = 0; i < history; i++)
+			loWindow[i] = lo[0];
+	}
+	memcpy(loWindow + history, lo, sizeof(T) * half);
+	memcpy(hiWindow + history + level.hiDelay, level.hi.data(), sizeof(T) * half);
+
+	T *even = _even.data();
+	T *odd = _odd.data();
+	memset(even, 0, sizeof(T) * half);
+	memset(odd, 0, sizeof(T) * half);
+
+	const Filter *filters[2] = { &_h, &_g };
+	const T *windows[2] = { loWindow, hiWindow };
+	for (int f = 0; f < 2; f++) {
+		const std::vector<T> &taps = filters[f]->taps;
+		const int Z = filters[f]->center;
+		const int L = int(taps.size());
+		for (int m = -Z; m < L - Z; m++) {
+			const T *window = windows[f] + _synthesisBack - m;
+			if (2 * m + Z >= 0 && 2 * m + Z < L)
+				Axpy(taps[2 * m + Z], window, half, even);
+			if (2 * m + 1 + Z >= 0 && 2 * m + 1 + Z < L)
+				Axpy(taps[2 * m + 1 + Z], window, half, odd);
+		}
+	}
+
+	T *output = level.output.data();
+	for (int t = 0; t < half; t++) {
+		output[2 * t] = 2 * even[t];
+		output[2 * t + 1] = 2 * odd[t];
+	}
+
+	memmove(loWindow, loWindow + half, sizeof(T) * history);
+	memmove(hiWindow, hiWindow + half, sizeof(T) * (history + level.hiDelay));
+}
+
+template <typename T>
+void StreamingWaveletTransformT<T>::analysis(const T *block)
+{
+	if (_levels.empty())
+		return;
+
+	for (int j = 0; j < _j; j++)
+		_analysisLevel(_levels[j], j ? _levels[j - 1].lo.data() : block);
+	_analysisStarted = true;
+}
+
+template <typename T>
+void StreamingWaveletTransformT<T>::synthesis(T *block)
+{
+	if (!_analysisStarted)
+		return;
+
+	for (int j = _j - 1; j >= 0; j--)
+		_synthesisLevel(_levels[j], j == _j - 1 ? _levels[j].lo.data() : _levels[j + 1].output.data());
+	_synthesisStarted = true;
+
+	memcpy(block, _levels[0].output.data(), sizeof(T) * _blockSize);
+}
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+template class StreamingWaveletTransformT<double>;
+template class StreamingWaveletTransformT<float>;
@@ -0,0 +1,112 @@
+#pragma once
+#include <vector>
+#include "FastWaveletTransform.h"
+
+//block streaming FastWaveletTransform: analysis() takes the next blockSize samples and gives
+//blockSize / 2^j coefficients of every detail j and blockSize / 2^J of the approximation,
+//synthesis() turns the (possibly changed) coefficients of the block back into blockSize samples.
+//Each level keeps the filter history it needs between blocks, so memory is bounded by the block
+//size and the filter lengths. Coefficients and samples come out with fixed delays: detail j of
+//block c starts at coefficient c * blockSize / 2^j - getDetailDelay(j), synthesized samples of
+//block c at sample c * blockSize - getLatency(). The stream is extended to the left with its first
+//sample; once the histories hold signal (the first getLatency() samples) the output is the
+//synthesis of the whole record away from its ends, the input itself for unchanged coefficients
+template <typename T>
+class StreamingWaveletTransformT : public FastWaveletTransformBase
+{
+public:
+	StreamingWaveletTransformT();
+
+	// Operations
+	bool init(const char* filter, int scales, int blockSize);     //blockSize: multiple of 2^scales
+	void close();
+
+	void analysis(const T *block);
+	void synthesis(T *block);
+
+	// Access
+	inline T* GetApproximation();                   //coefficients of the last analysed block
+	inline T* GetDetail(int j);                     //j = 1 (finest) .. getJ()
+	inline int getJ() const;
+	inline int getBlockSize() const;
+	int getDetailDelay(int j) const;                //in coefficients of level j
+	int getLatency() const;                         //synthesis delay in samples
+
+private:
+	StreamingWaveletTransformT(const StreamingWaveletTransformT& swt) = delete;
+	const StreamingWaveletTransformT& operator=(const StreamingWaveletTransformT& swt) = delete;
+
+	struct Filter {
+		std::vector<T> taps;
+		int center;
+	};
+
+	//level j + 1 bands of the level j input (signal for j = 0), buffers are [history | block]
+	struct Level {
+		int size;                  //level input samples per block
+		int bandStart;             //coefficient index of the first lo, hi of block 0
+		int analysisHistory;
+		std::vector<T> input;
+		std::vector<T> lo, hi;     //analysis output of the block
+
+		int loStart;               //coefficient index of the first synthesis lo of block 0
+		int hiDelay;               //detail coefficients held back to line up with lo
+		std::vector<T> loHistory;  //[synthesis history | block]
+		std::vector<T> hiHistory;  //[synthesis history | block | hiDelay newer]
+		std::vector<T> output;     //synthesis output of the block, size samples
+	};
+
+	void _analysisLevel(Level &level, const T *block);
+	void _synthesisLevel(Level &level, const T *lo);
+	static void _reach(const Filter &filter, bool synthesis, int &back, int &forward);
+
+	Filter _tH, _tG;           //analysis filters
+	Filter _h, _g;             //synth filters
+	int _analysisBack, _analysisForward;       //input samples before and after 2k
+	int _synthesisBack, _synthesisForward;     //coefficients before and after k
+
+	int _j;
+	int _blockSize;
+	bool _analysisStarted;     //histories filled from the first block
+	bool _synthesisStarted;
+	std::vector<Level> _levels;
+	std::vector<T> _even, _odd;     //input channels or output samples of a level
+};
+
+typedef StreamingWaveletTransformT<double> StreamingWaveletTransform;
+typedef StreamingWaveletTransformT<float> StreamingWaveletTransformF;
+
+/*//////////////////////////////////////////////
+		StreamingWaveletTransform stream;
+		stream.init("bior97.flt", J, 1024);
+		while (read 1024 samples to block) {
+			stream.analysis(block);
+			threshold stream.GetDetail(j), j = 1..J
+			stream.synthesis(block);             //1024 samples, stream.getLatency() late
+		}
+//////////////////////////////////////////////*/
+
+// Inlines
+template <typename T>
+inline T* StreamingWaveletTransformT<T>::GetApproximation()
+{
+	return _levels[_j - 1].lo.data();
+}
+
+template <typename T>
+inline T* StreamingWaveletTransformT<T>::GetDetail(int j)
+{
+	return _levels[j - 1].hi.data();
+}
+
+template <typename T>
+inline int StreamingWaveletTransformT<T>::getJ() const
+{
+	return _j;
+}
+
+template <typename T>
+inline int StreamingWaveletTransformT<T>::getBlockSize() const
+{
+	return _blockSize;
+}
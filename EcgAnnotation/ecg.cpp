@@ -80,36 +80,34 @@ int main(int argc, char* argv[])
 
 		printf(" getting QRS complexes... ");
 		tic();
-		int** qrsAnn = ann.getQRS(data, size, sampleRate);         //get QRS complexes                        
+		AnnotationTable* qrsAnn = ann.getQRS(data, size, sampleRate);         //get QRS complexes                        
 		if (qrsAnn) {
 			printf(" %d beats.\n", ann.getQRSNumber());
-			ann.getEctopia(qrsAnn, ann.getQRSNumber(), sampleRate);        //label Ectopic beats
+			ann.getEctopia(*qrsAnn, sampleRate);        //label Ectopic beats
 
 			printf(" getting P, T waves... ");
-			int annNum;
-			int** ANN = ann.getPTU(data, size, sampleRate, qrsAnn, ann.getQRSNumber());     //find P,T waves
-			if (ANN) {
-				annNum = ann.getAnnotationSize();
+			AnnotationView ANN;
+			if (ann.getPTU(data, size, sampleRate, *qrsAnn)) {     //find P,T waves
+				ANN = ann.getAnnotation();
 				printf(" done.\n");
 				toc();
 				printf("\n");
 				//save ECG annotation
 				strcpy(annName, argv[1]);
 				change_extension(annName, ".atr");
-				ann.SaveAnnotation(annName, ANN, annNum);
+				ann.SaveAnnotation(annName, ANN);
 			}
 			else {
-				ANN = qrsAnn;
-				annNum = 2 * ann.getQRSNumber();
+				ANN = *qrsAnn;
 				printf(" failed.\n");
 				toc();
 				printf("\n");
 			}
 
 			//printing out annotation
-			for (int i = 0; i < annNum; i++) {
-				const int sample = ANN[i][0];
-				const int type = ANN[i][1];
+			for (int i = 0; i < ANN.getSize(); i++) {
+				const int sample = ANN.sample(i);
+				const int type = ANN.type(i);
 
 				millisecond = int((double(sample) / sampleRate) * 1000.0);
 				signal->mSecToTime(millisecond, h, m, s, ms);
@@ -125,7 +123,7 @@ int main(int argc, char* argv[])
 			
 			strcpy(hrvName, argv[1]);
 			change_extension(hrvName, ".hrv");
-			if (ann.getRRSequence(ANN, annNum, sampleRate, &rrs, &rrsPos)) {
+			if (ann.getRRSequence(ANN, sampleRate, &rrs, &rrsPos)) {
 				FILE *fp = fopen(hrvName, "wt");
 				for (int i = 0; i < int(rrs.size()); i++)
 					fprintf(fp, "%lf\n", rrs[i]);
@@ -136,7 +134,7 @@ int main(int argc, char* argv[])
 
 		}
 		else {
-			printf(" could not get QRS complexes. make sure you have got \"filters\" directory in the ecg application dir.");
+			printf(" could not get QRS complexes.");
 			exit(1);
 		}
 
@@ -152,7 +150,6 @@ int main(int argc, char* argv[])
 void help()
 {
 	printf("usage: ecg.exe physioNetFile.dat [LeadNumber] [params]\n");
-	printf("       do not forget about filters dir to be present.");
 }
 
 static LARGE_INTEGER m_nFreq;
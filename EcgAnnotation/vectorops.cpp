@@ -0,0 +1,372 @@
+#include "vectorops.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VECTOROPS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define VECTOROPS_NEON
+#include <arm_neon.h>
+#endif
+
+typedef double (*DOT_FUNC)(const double*, const double*, int);
+typedef void (*DOT2_FUNC)(const double*, const double*, const double*, int, double&, double&);
+typedef float (*DOTF_FUNC)(const float*, const float*, int);
+typedef void (*DOT2F_FUNC)(const float*, const float*, const float*, int, float&, float&);
+typedef void (*AXPY_FUNC)(double, const double*, int, double*);
+typedef void (*AXPYF_FUNC)(float, const float*, int, float*);
+
+template <typename T>
+static T dotScalar(const T* a, const T* x, int size)
+{
+	T r = 0;
+	for (int i = 0; i < size; i++)
+		r += a[i] * x[i];
+	return r;
+}
+
+template <typename T>
+static void dot2Scalar(const T* a, const T* b, const T* x, int size, T& ra, T& rb)
+{
+	ra = 0;
+	rb = 0;
+	for (int i = 0; i < size; i++) {
+		ra += a[i] * x[i];
+		rb += b[i] * x[i];
+	}
+}
+
+template <typename T>
+static void axpyScalar(T c, const T* x, int size, T* y)
+{
+	for (int i = 0; i < size; i++)
+		y[i] += c * x[i];
+}
+
+#ifdef VECTOROPS_X86
+TARGET_AVX2 static double sumAvx2(__m256d v)
+{
+	const __m128d lo = _mm256_castpd256_pd128(v);
+	const __m128d hi = _mm256_extractf128_pd(v, 1);
+	const __m128d s = _mm_add_pd(lo, hi);
+	return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+TARGET_AVX2 static double dotAvx2(const double* a, const double* x, int size)
+{
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	int i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(x + i), s0);
+		s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(x + i + 4), s1);
+	}
+	if (i + 4 <= size) {
+		s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(x + i), s0);
+		i += 4;
+	}
+
+	double r = sumAvx2(_mm256_add_pd(s0, s1));
+	for (; i < size; i++)
+		r += a[i] * x[i];
+	return r;
+}
+
+TARGET_AVX2 static void dot2Avx2(const double* a, const double* b, const double* x, int size, double& ra, double& rb)
+{
+	__m256d sa = _mm256_setzero_pd();
+	__m256d sb = _mm256_setzero_pd();
+	int i = 0;
+
+	for (; i + 4 <= size; i += 4) {
+		const __m256d vx = _mm256_loadu_pd(x + i);
+		sa = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), vx, sa);
+		sb = _mm256_fmadd_pd(_mm256_loadu_pd(b + i), vx, sb);
+	}
+
+	ra = sumAvx2(sa);
+	rb = sumAvx2(sb);
+	for (; i < size; i++) {
+		ra += a[i] * x[i];
+		rb += b[i] * x[i];
+	}
+}
+
+TARGET_AVX2 static float sumAvx2(__m256 v)
+{
+	const __m128 lo = _mm256_castps256_ps128(v);
+	const __m128 hi = _mm256_extractf128_ps(v, 1);
+	__m128 s = _mm_add_ps(lo, hi);
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+
+TARGET_AVX2 static float dotAvx2(const float* a, const float* x, int size)
+{
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	int i = 0;
+
+	for (; i + 16 <= size; i += 16) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(x + i), s0);
+		s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(x + i + 8), s1);
+	}
+	if (i + 8 <= size) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(x + i), s0);
+		i += 8;
+	}
+
+	float r = sumAvx2(_mm256_add_ps(s0, s1));
+	for (; i < size; i++)
+		r += a[i] * x[i];
+	return r;
+}
+
+TARGET_AVX2 static void dot2Avx2(const float* a, const float* b, const float* x, int size, float& ra, float& rb)
+{
+	__m256 sa = _mm256_setzero_ps();
+	__m256 sb = _mm256_setzero_ps();
+	int i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+		const __m256 vx = _mm256_loadu_ps(x + i);
+		sa = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), vx, sa);
+		sb = _mm256_fmadd_ps(_mm256_loadu_ps(b + i), vx, sb);
+	}
+
+	ra = sumAvx2(sa);
+	rb = sumAvx2(sb);
+	for (; i < size; i++) {
+		ra += a[i] * x[i];
+		rb += b[i] * x[i];
+	}
+}
+
+TARGET_AVX2 static void axpyAvx2(double c, const double* x, int size, double* y)
+{
+	const __m256d vc = _mm256_set1_pd(c);
+	int i = 0;
+
+	for (; i + 4 <= size; i += 4)
+		_mm256_storeu_pd(y + i, _mm256_fmadd_pd(vc, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+	for (; i < size; i++)
+		y[i] += c * x[i];
+}
+
+TARGET_AVX2 static void axpyAvx2(float c, const float* x, int size, float* y)
+{
+	const __m256 vc = _mm256_set1_ps(c);
+	int i = 0;
+
+	for (; i + 8 <= size; i += 8)
+		_mm256_storeu_ps(y + i, _mm256_fmadd_ps(vc, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+	for (; i < size; i++)
+		y[i] += c * x[i];
+}
+
+static bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	const bool fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!fma || !osxsave || !avx)
+		return false;
+	if ((_xgetbv(0) & 6) != 6)               //OS saves YMM state
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+#ifdef VECTOROPS_NEON
+static double dotNeon(const double* a, const double* x, int size)
+{
+	float64x2_t s0 = vdupq_n_f64(0);
+	float64x2_t s1 = vdupq_n_f64(0);
+	int i = 0;
+
+	for (; i + 4 <= size; i += 4) {
+		s0 = vfmaq_f64(s0, vld1q_f64(a + i), vld1q_f64(x + i));
+		s1 = vfmaq_f64(s1, vld1q_f64(a + i + 2), vld1q_f64(x + i + 2));
+	}
+
+	double r = vaddvq_f64(vaddq_f64(s0, s1));
+	for (; i < size; i++)
+		r += a[i] * x[i];
+	return r;
+}
+
+static void dot2Neon(const double* a, const double* b, const double* x, int size, double& ra, double& rb)
+{
+	float64x2_t sa = vdupq_n_f64(0);
+	float64x2_t sb = vdupq_n_f64(0);
+	int i = 0;
+
+	for (; i + 2 <= size; i += 2) {
+		const float64x2_t vx = vld1q_f64(x + i);
+		sa = vfmaq_f64(sa, vld1q_f64(a + i), vx);
+		sb = vfmaq_f64(sb, vld1q_f64(b + i), vx);
+	}
+
+	ra = vaddvq_f64(sa);
+	rb = vaddvq_f64(sb);
+	for (; i < size; i++) {
+		ra += a[i] * x[i];
+		rb += b[i] * x[i];
+	}
+}
+
+static float dotNeon(const float* a, const float* x, int size)
+{
+	float32x4_t s0 = vdupq_n_f32(0);
+	float32x4_t s1 = vdupq_n_f32(0);
+	int i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+		s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(x + i));
+		s1 = vfmaq_f32(s1, vld1q_f32(a + i + 4), vld1q_f32(x + i + 4));
+	}
+
+	float r = vaddvq_f32(vaddq_f32(s0, s1));
+	for (; i < size; i++)
+		r += a[i] * x[i];
+	return r;
+}
+
+static void dot2Neon(const float* a, const float* b, const float* x, int size, float& ra, float& rb)
+{
+	float32x4_t sa = vdupq_n_f32(0);
+	float32x4_t sb = vdupq_n_f32(0);
+	int i = 0;
+
+	for (; i + 4 <= size; i += 4) {
+		const float32x4_t vx = vld1q_f32(x + i);
+		sa = vfmaq_f32(sa, vld1q_f32(a + i), vx);
+		sb = vfmaq_f32(sb, vld1q_f32(b + i), vx);
+	}
+
+	ra = vaddvq_f32(sa);
+	rb = vaddvq_f32(sb);
+	for (; i < size; i++) {
+		ra += a[i] * x[i];
+		rb += b[i] * x[i];
+	}
+}
+
+static void axpyNeon(double c, const double* x, int size, double* y)
+{
+	const float64x2_t vc = vdupq_n_f64(c);
+	int i = 0;
+
+	for (; i + 2 <= size; i += 2)
+		vst1q_f64(y + i, vfmaq_f64(vld1q_f64(y + i), vc, vld1q_f64(x + i)));
+	for (; i < size; i++)
+		y[i] += c * x[i];
+}
+
+static void axpyNeon(float c, const float* x, int size, float* y)
+{
+	const float32x4_t vc = vdupq_n_f32(c);
+	int i = 0;
+
+	for (; i + 4 <= size; i += 4)
+		vst1q_f32(y + i, vfmaq_f32(vld1q_f32(y + i), vc, vld1q_f32(x + i)));
+	for (; i < size; i++)
+		y[i] += c * x[i];
+}
+#endif
+
+struct VECTOR_OPS {
+	DOT_FUNC dot;
+	DOT2_FUNC dot2;
+	DOTF_FUNC dotf;
+	DOT2F_FUNC dot2f;
+	AXPY_FUNC axpy;
+	AXPYF_FUNC axpyf;
+	const char* name;
+};
+
+static VECTOR_OPS selectVectorOps()
+{
+	VECTOR_OPS ops = { dotScalar<double>, dot2Scalar<double>, dotScalar<float>, dot2Scalar<float>,
+	                   axpyScalar<double>, axpyScalar<float>, "scalar" };
+#if defined(VECTOROPS_X86)
+	if (cpuHasAvx2()) {
+		ops.dot = dotAvx2;
+		ops.dot2 = dot2Avx2;
+		ops.dotf = dotAvx2;
+		ops.dot2f = dot2Avx2;
+		ops.axpy = axpyAvx2;
+		ops.axpyf = axpyAvx2;
+		ops.name = "avx2";
+	}
+#elif defined(VECTOROPS_NEON)
+	ops.dot = dotNeon;
+	ops.dot2 = dot2Neon;
+	ops.dotf = dotNeon;
+	ops.dot2f = dot2Neon;
+	ops.axpy = axpyNeon;
+	ops.axpyf = axpyNeon;
+	ops.name = "neon";
+#endif
+	return ops;
+}
+
+static const VECTOR_OPS& vectorOps()
+{
+	static const VECTOR_OPS ops = selectVectorOps();       //cpu checked once
+	return ops;
+}
+
+double Dot(const double* a, const double* x, int size)
+{
+	return vectorOps().dot(a, x, size);
+}
+
+void Dot2(const double* a, const double* b, const double* x, int size, double& ra, double& rb)
+{
+	vectorOps().dot2(a, b, x, size, ra, rb);
+}
+
+float Dot(const float* a, const float* x, int size)
+{
+	return vectorOps().dotf(a, x, size);
+}
+
+void Dot2(const float* a, const float* b, const float* x, int size, float& ra, float& rb)
+{
+	vectorOps().dot2f(a, b, x, size, ra, rb);
+}
+
+void Axpy(double c, const double* x, int size, double* y)
+{
+	vectorOps().axpy(c, x, size, y);
+}
+
+void Axpy(float c, const float* x, int size, float* y)
+{
+	vectorOps().axpyf(c, x, size, y);
+}
+
+const char* VectorInstructionSet()
+{
+	return vectorOps().name;
+}
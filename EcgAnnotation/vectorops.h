@@ -0,0 +1,13 @@
+#pragma once
+
+//inner products and scaled sums for the transform kernels
+//AVX2/FMA (x86) or NEON (ARM64) selected at runtime, portable scalar code otherwise
+
+double Dot(const double* a, const double* x, int size);                                   //sum a[i]*x[i]
+void Dot2(const double* a, const double* b, const double* x, int size, double& ra, double& rb);  //a.x and b.x in one pass
+float Dot(const float* a, const float* x, int size);                                      //twice the lanes per vector
+void Dot2(const float* a, const float* b, const float* x, int size, float& ra, float& rb);
+void Axpy(double c, const double* x, int size, double* y);                                //y[i] += c*x[i]
+void Axpy(float c, const float* x, int size, float* y);
+
+const char* VectorInstructionSet();        //"avx2", "neon" or "scalar"
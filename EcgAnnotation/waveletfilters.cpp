@@ -0,0 +1,643 @@
+#include <string.h>
+#include "waveletfilters.h"
+
+//taps of filters/*.flt, same order and rounding as the files
+static constexpr double bior13[] = {
+	//tH
+	-0.0625, 0.0625, 0.5, 0.5,
+	0.0625, -0.0625,
+	//tG
+	0.0, 0.0, -0.5, 0.5,
+	//h
+	0.5, 0.5,
+	//g
+	-0.0625, -0.0625, 0.5, -0.5,
+	0.0625, 0.0625
+};
+
+static constexpr double bior15[] = {
+	//tH
+	0.01171875, -0.01171875, -0.0859375, 0.0859375,
+	0.5, 0.5, 0.0859375, -0.0859375,
+	-0.01171875, 0.01171875,
+	//tG
+	0.0, 0.0, -0.5, 0.5,
+	//h
+	0.5, 0.5,
+	//g
+	0.01171875, 0.01171875, -0.0859375, -0.0859375,
+	0.5, -0.5, 0.0859375, 0.0859375,
+	-0.01171875, -0.01171875
+};
+
+static constexpr double bior22[] = {
+	//tH
+	-0.125, 0.25, 0.75, 0.25,
+	-0.125,
+	//tG
+	0.0, 0.0, -0.25, 0.5,
+	-0.25,
+	//h
+	0.25, 0.5, 0.25,
+	//g
+	-0.125, -0.25, 0.75, -0.25,
+	-0.125
+};
+
+static constexpr double bior24[] = {
+	//tH
+	0.0234375, -0.046875, -0.125, 0.296875,
+	0.703125, 0.296875, -0.125, -0.046875,
+	0.0234375,
+	//tG
+	0.0, 0.0, -0.25, 0.5,
+	-0.25,
+	//h
+	0.25, 0.5, 0.25,
+	//g
+	0.0234375, 0.046875, -0.125, -0.296875,
+	0.703125, -0.296875, -0.125, 0.046875,
+	0.0234375
+};
+
+static constexpr double bior26[] = {
+	//tH
+	-0.0048828125, 0.009765625, 0.033203125, -0.076171875,
+	-0.1201171875, 0.31640625, 0.68359375, 0.31640625,
+	-0.1201171875, -0.076171875, 0.033203125, 0.009765625,
+	-0.0048828125,
+	//tG
+	0.0, 0.0, -0.25, 0.5,
+	-0.25,
+	//h
+	0.25, 0.5, 0.25,
+	//g
+	-0.0048828125, -0.009765625, 0.033203125, 0.076171875,
+	-0.1201171875, -0.31640625, 0.68359375, -0.31640625,
+	-0.1201171875, 0.076171875, 0.033203125, -0.009765625,
+	-0.0048828125
+};
+
+static constexpr double bior28[] = {
+	//tH
+	0.001068115234375, -0.00213623046875, -0.0091552734375, 0.02044677734375,
+	0.0374755859375, -0.09539794921875, -0.1158447265625, 0.32708740234375,
+	0.67291259765625, 0.32708740234375, -0.1158447265625, -0.09539794921875,
+	0.0374755859375, 0.02044677734375, -0.0091552734375, -0.00213623046875,
+	0.001068115234375,
+	//tG
+	0.0, 0.0, -0.25, 0.5,
+	-0.25,
+	//h
+	0.25, 0.5, 0.25,
+	//g
+	0.001068115234375, 0.00213623046875, -0.0091552734375, -0.02044677734375,
+	0.0374755859375, 0.09539794921875, -0.1158447265625, -0.32708740234375,
+	0.67291259765625, -0.32708740234375, -0.1158447265625, 0.09539794921875,
+	0.0374755859375, -0.02044677734375, -0.0091552734375, 0.00213623046875,
+	0.001068115234375
+};
+
+static constexpr double bior31[] = {
+	//tH
+	-0.25, 0.75, 0.75, -0.25,
+	//tG
+	0.125, -0.375, 0.375, -0.125,
+	//h
+	0.125, 0.375, 0.375, 0.125,
+	//g
+	-0.25, -0.75, 0.75, 0.25
+};
+
+static constexpr double bior33[] = {
+	//tH
+	0.046875, -0.140625, -0.109375, 0.703125,
+	0.703125, -0.109375, -0.140625, 0.046875,
+	//tG
+	0.0, 0.0, 0.125, -0.375,
+	0.375, -0.125,
+	//h
+	0.125, 0.375, 0.375, 0.125,
+	//g
+	0.046875, 0.140625, -0.109375, -0.703125,
+	0.703125, 0.109375, -0.140625, -0.046875
+};
+
+static constexpr double bior35[] = {
+	//tH
+	-0.009765625, 0.029296875, 0.037109375, -0.189453125,
+	-0.05078125, 0.68359375, 0.68359375, -0.05078125,
+	-0.189453125, 0.037109375, 0.029296875, -0.009765625,
+	//tG
+	0.0, 0.0, 0.125, -0.375,
+	0.375, -0.125,
+	//h
+	0.125, 0.375, 0.375, 0.125,
+	//g
+	-0.009765625, -0.029296875, 0.037109375, 0.189453125,
+	-0.05078125, -0.68359375, 0.68359375, 0.05078125,
+	-0.189453125, -0.037109375, 0.029296875, 0.009765625
+};
+
+static constexpr double bior37[] = {
+	//tH
+	0.00213623046875, -0.00640869140625, -0.01190185546875, 0.05279541015625,
+	0.02215576171875, -0.21295166015625, -0.01873779296875, 0.67291259765625,
+	0.67291259765625, -0.01873779296875, -0.21295166015625, 0.02215576171875,
+	0.05279541015625, -0.01190185546875, -0.00640869140625, 0.00213623046875,
+	//tG
+	0.0, 0.0, 0.125, -0.375,
+	0.375, -0.125,
+	//h
+	0.125, 0.375, 0.375, 0.125,
+	//g
+	0.00213623046875, 0.00640869140625, -0.01190185546875, -0.05279541015625,
+	0.02215576171875, 0.21295166015625, -0.01873779296875, -0.67291259765625,
+	0.67291259765625, 0.01873779296875, -0.21295166015625, -0.02215576171875,
+	0.05279541015625, 0.01190185546875, -0.00640869140625, -0.00213623046875
+};
+
+static constexpr double bior39[] = {
+	//tH
+	-0.00048065185546875, 0.00144195556640625, 0.00357818603515625, -0.01457977294921875,
+	-0.009979248046875, 0.070098876953125, 0.008697509765625, -0.226409912109375,
+	0.0014495849609375, 0.6661834716796875, 0.6661834716796875, 0.0014495849609375,
+	-0.226409912109375, 0.008697509765625, 0.070098876953125, -0.009979248046875,
+	-0.01457977294921875, 0.00357818603515625, 0.00144195556640625, -0.00048065185546875,
+	//tG
+	0.0, 0.0, 0.125, -0.375,
+	0.375, -0.125,
+	//h
+	0.125, 0.375, 0.375, 0.125,
+	//g
+	-0.00048065185546875, -0.00144195556640625, 0.00357818603515625, 0.01457977294921875,
+	-0.009979248046875, -0.070098876953125, 0.008697509765625, 0.226409912109375,
+	0.0014495849609375, -0.6661834716796875, 0.6661834716796875, -0.0014495849609375,
+	-0.226409912109375, -0.008697509765625, 0.070098876953125, 0.009979248046875,
+	-0.01457977294921875, -0.00357818603515625, 0.00144195556640625, 0.00048065185546875
+};
+
+static constexpr double bior46[] = {
+	//tH
+	0.00427246094, -0.0170898438, -0.00671386719, 0.112304688,
+	-0.0679931641, -0.357910156, 0.32043457, 1.02539062,
+	0.32043457, -0.357910156, -0.0679931641, 0.112304688,
+	-0.00671386719, -0.0170898438, 0.00427246094,
+	//tG
+	0.0, 0.0, -0.0625, 0.25,
+	-0.375, 0.25, -0.0625,
+	//h
+	0.0625, 0.25, 0.375, 0.25,
+	0.0625,
+	//g
+	0.00427246094, 0.0170898438, -0.00671386719, -0.112304688,
+	-0.0679931641, 0.357910156, 0.32043457, -1.02539062,
+	0.32043457, 0.357910156, -0.0679931641, -0.112304688,
+	-0.00671386719, 0.0170898438, 0.00427246094
+};
+
+static constexpr double bior48[] = {
+	//tH
+	-0.000961303711, 0.00384521484, 0.00331115723, -0.0324707031,
+	0.012512207, 0.127685547, -0.110290527, -0.342529297,
+	0.345428467, 0.986938477, 0.345428467, -0.342529297,
+	-0.110290527, 0.127685547, 0.012512207, -0.0324707031,
+	0.00331115723, 0.00384521484, -0.000961303711,
+	//tG
+	0.0, 0.0, -0.0625, 0.25,
+	-0.375, 0.25, -0.0625,
+	//h
+	0.0625, 0.25, 0.375, 0.25,
+	0.0625,
+	//g
+	-0.000961303711, -0.00384521484, 0.00331115723, 0.0324707031,
+	0.012512207, -0.127685547, -0.110290527, 0.342529297,
+	0.345428467, -0.986938477, 0.345428467, 0.342529297,
+	-0.110290527, -0.127685547, 0.012512207, 0.0324707031,
+	0.00331115723, -0.00384521484, -0.000961303711
+};
+
+static constexpr double bior97[] = {
+	//tH
+	0.02675, -0.01686, -0.07822, 0.26686,
+	0.60295, 0.26686, -0.07822, -0.01686,
+	0.02675,
+	//tG
+	0.0, 0.0, 0.045635, -0.02877,
+	-0.295635, 0.55754, -0.295635, -0.02877,
+	0.045635,
+	//h
+	-0.045635, -0.02877, 0.295635, 0.55754,
+	0.295635, -0.02877, -0.045635,
+	//g
+	0.02675, 0.01686, -0.07822, -0.26686,
+	0.60295, -0.26686, -0.07822, 0.01686,
+	0.02675
+};
+
+static constexpr double coif1[] = {
+	//tH
+	-0.051429728470999997, 0.238929728471, 0.60285945694200005, 0.27214054305800001,
+	-0.051429728470999997, -0.011070271529000001,
+	//tG
+	-0.011070271529000001, 0.051429728470999997, 0.27214054305800001, -0.60285945694200005,
+	0.238929728471, 0.051429728470999997,
+	//h
+	-0.051429728470999997, 0.238929728471, 0.60285945694200005, 0.27214054305800001,
+	-0.051429728470999997, -0.011070271529000001,
+	//g
+	-0.011070271529000001, 0.051429728470999997, 0.27214054305800001, -0.60285945694200005,
+	0.238929728471, 0.051429728470999997
+};
+
+static constexpr double coif2[] = {
+	//tH
+	0.011587596739, -0.029320137980000001, -0.04763959031, 0.27302104653499998,
+	0.57468239385700004, 0.29486719369600001, -0.054085607091999999, -0.042026480461,
+	0.016744410163, 0.0039678836129999999, -0.0012892033559999999, -0.00050950539899999997,
+	//tG
+	-0.00050950539899999997, 0.0012892033559999999, 0.0039678836129999999, -0.016744410163,
+	-0.042026480461, 0.054085607091999999, 0.29486719369600001, -0.57468239385700004,
+	0.27302104653499998, 0.04763959031, -0.029320137980000001, -0.011587596739,
+	//h
+	0.011587596739, -0.029320137980000001, -0.04763959031, 0.27302104653499998,
+	0.57468239385700004, 0.29486719369600001, -0.054085607091999999, -0.042026480461,
+	0.016744410163, 0.0039678836129999999, -0.0012892033559999999, -0.00050950539899999997,
+	//g
+	-0.00050950539899999997, 0.0012892033559999999, 0.0039678836129999999, -0.016744410163,
+	-0.042026480461, 0.054085607091999999, 0.29486719369600001, -0.57468239385700004,
+	0.27302104653499998, 0.04763959031, -0.029320137980000001, -0.011587596739
+};
+
+static constexpr double coif3[] = {
+	//tH
+	-0.0026824186710000001, 0.0055031267089999999, 0.016583560479, -0.046507764478999999,
+	-0.04322076356, 0.28650333527400001, 0.56128525686999997, 0.302983571773,
+	-0.050770140754999998, -0.058196250762000003, 0.024434094321000001, 0.011229240962,
+	-0.0063696010110000003, -0.0018204589160000001, 0.00079020510100000002, 0.00032966517399999999,
+	-0.000050192775, -0.000024465734,
+	//tG
+	-0.000024465734, 0.000050192775, 0.00032966517399999999, -0.00079020510100000002,
+	-0.0018204589160000001, 0.0063696010110000003, 0.011229240962, -0.024434094321000001,
+	-0.058196250762000003, 0.050770140754999998, 0.302983571773, -0.56128525686999997,
+	0.28650333527400001, 0.04322076356, -0.046507764478999999, -0.016583560479,
+	0.0055031267089999999, 0.0026824186710000001,
+	//h
+	-0.0026824186710000001, 0.0055031267089999999, 0.016583560479, -0.046507764478999999,
+	-0.04322076356, 0.28650333527400001, 0.56128525686999997, 0.302983571773,
+	-0.050770140754999998, -0.058196250762000003, 0.024434094321000001, 0.011229240962,
+	-0.0063696010110000003, -0.0018204589160000001, 0.00079020510100000002, 0.00032966517399999999,
+	-0.000050192775, -0.000024465734,
+	//g
+	-0.000024465734, 0.000050192775, 0.00032966517399999999, -0.00079020510100000002,
+	-0.0018204589160000001, 0.0063696010110000003, 0.011229240962, -0.024434094321000001,
+	-0.058196250762000003, 0.050770140754999998, 0.302983571773, -0.56128525686999997,
+	0.28650333527400001, 0.04322076356, -0.046507764478999999, -0.016583560479,
+	0.0055031267089999999, 0.0026824186710000001
+};
+
+static constexpr double coif4[] = {
+	//tH
+	0.00063096104600000001, -0.0011522248519999999, -0.0051945240259999997, 0.011362459244000001,
+	0.018867235377999999, -0.057464234428999998, -0.039652648516999997, 0.29366739089499999,
+	0.55312645256199999, 0.30715732619800001, -0.047112738865000003, -0.068038127051,
+	0.027813640152999999, 0.017735837438000002, -0.010756318516999999, -0.0040010128859999999,
+	0.0026526659459999999, 0.00089559452900000005, -0.00041650057099999998, -0.00018382976900000001,
+	0.000044080354, 0.000022082857, -0.000002304942, -0.000001262175,
+	//tG
+	-0.000001262175, 0.000002304942, 0.000022082857, -0.000044080354,
+	-0.00018382976900000001, 0.00041650057099999998, 0.00089559452900000005, -0.0026526659459999999,
+	-0.0040010128859999999, 0.010756318516999999, 0.017735837438000002, -0.027813640152999999,
+	-0.068038127051, 0.047112738865000003, 0.30715732619800001, -0.55312645256199999,
+	0.29366739089499999, 0.039652648516999997, -0.057464234428999998, -0.018867235377999999,
+	0.011362459244000001, 0.0051945240259999997, -0.0011522248519999999, -0.00063096104600000001,
+	//h
+	0.00063096104600000001, -0.0011522248519999999, -0.0051945240259999997, 0.011362459244000001,
+	0.018867235377999999, -0.057464234428999998, -0.039652648516999997, 0.29366739089499999,
+	0.55312645256199999, 0.30715732619800001, -0.047112738865000003, -0.068038127051,
+	0.027813640152999999, 0.017735837438000002, -0.010756318516999999, -0.0040010128859999999,
+	0.0026526659459999999, 0.00089559452900000005, -0.00041650057099999998, -0.00018382976900000001,
+	0.000044080354, 0.000022082857, -0.000002304942, -0.000001262175,
+	//g
+	-0.000001262175, 0.000002304942, 0.000022082857, -0.000044080354,
+	-0.00018382976900000001, 0.00041650057099999998, 0.00089559452900000005, -0.0026526659459999999,
+	-0.0040010128859999999, 0.010756318516999999, 0.017735837438000002, -0.027813640152999999,
+	-0.068038127051, 0.047112738865000003, 0.30715732619800001, -0.55312645256199999,
+	0.29366739089499999, 0.039652648516999997, -0.057464234428999998, -0.018867235377999999,
+	0.011362459244000001, 0.0051945240259999997, -0.0011522248519999999, -0.00063096104600000001
+};
+
+static constexpr double coif5[] = {
+	//tH
+	-0.0001499638, 0.00025356119999999998, 0.0015402457, -0.0029411108000000001,
+	-0.0071637819, 0.016552066399999999, 0.019917804300000001, -0.064997262799999997,
+	-0.036800073599999997, 0.29809232349999998, 0.54750542940000002, 0.30970684900000001,
+	-0.0438660508, -0.074652238900000001, 0.029195879500000001, 0.023110776999999999,
+	-0.0139736879, -0.00648009, 0.0047830014000000004, 0.0017206547000000001,
+	-0.0011758222, -0.00045122700000000001, 0.00021372979999999999, 0.0000993776,
+	-0.0000292321, -0.000015072, 0.0000026408, 0.0000014593,
+	-0.0000001184, -0.0000000673,
+	//tG
+	-0.0000000673, 0.0000001184, 0.0000014593, -0.0000026408,
+	-0.000015072, 0.0000292321, 0.0000993776, -0.00021372979999999999,
+	-0.00045122700000000001, 0.0011758222, 0.0017206547000000001, -0.0047830014000000004,
+	-0.00648009, 0.0139736879, 0.023110776999999999, -0.029195879500000001,
+	-0.074652238900000001, 0.0438660508, 0.30970684900000001, -0.54750542940000002,
+	0.29809232349999998, 0.036800073599999997, -0.064997262799999997, -0.019917804300000001,
+	0.016552066399999999, 0.0071637819, -0.0029411108000000001, -0.0015402457,
+	0.00025356119999999998, 0.0001499638,
+	//h
+	-0.0001499638, 0.00025356119999999998, 0.0015402457, -0.0029411108000000001,
+	-0.0071637819, 0.016552066399999999, 0.019917804300000001, -0.064997262799999997,
+	-0.036800073599999997, 0.29809232349999998, 0.54750542940000002, 0.30970684900000001,
+	-0.0438660508, -0.074652238900000001, 0.029195879500000001, 0.023110776999999999,
+	-0.0139736879, -0.00648009, 0.0047830014000000004, 0.0017206547000000001,
+	-0.0011758222, -0.00045122700000000001, 0.00021372979999999999, 0.0000993776,
+	-0.0000292321, -0.000015072, 0.0000026408, 0.0000014593,
+	-0.0000001184, -0.0000000673,
+	//g
+	-0.0000000673, 0.0000001184, 0.0000014593, -0.0000026408,
+	-0.000015072, 0.0000292321, 0.0000993776, -0.00021372979999999999,
+	-0.00045122700000000001, 0.0011758222, 0.0017206547000000001, -0.0047830014000000004,
+	-0.00648009, 0.0139736879, 0.023110776999999999, -0.029195879500000001,
+	-0.074652238900000001, 0.0438660508, 0.30970684900000001, -0.54750542940000002,
+	0.29809232349999998, 0.036800073599999997, -0.064997262799999997, -0.019917804300000001,
+	0.016552066399999999, 0.0071637819, -0.0029411108000000001, -0.0015402457,
+	0.00025356119999999998, 0.0001499638
+};
+
+static constexpr double daub1[] = {
+	//tH
+	0.5, 0.5,
+	//tG
+	0.5, -0.5,
+	//h
+	0.5, 0.5,
+	//g
+	0.5, -0.5
+};
+
+static constexpr double daub2[] = {
+	//tH
+	0.3415063509462205, 0.5915063509458669, 0.15849364905377947, -0.091506350945866982,
+	//tG
+	-0.091506350945866982, -0.15849364905377947, 0.5915063509458669, -0.3415063509462205,
+	//h
+	0.3415063509462205, 0.5915063509458669, 0.15849364905377947, -0.091506350945866982,
+	//g
+	-0.091506350945866982, -0.15849364905377947, 0.5915063509458669, -0.3415063509462205
+};
+
+static constexpr double daub3[] = {
+	//tH
+	0.23523360389270459, 0.57055845791730841, 0.32518250026371026, -0.0954672077842601,
+	-0.060416104155354193, 0.024908749865890957,
+	//tG
+	0.024908749865890957, 0.060416104155354193, -0.0954672077842601, -0.32518250026371026,
+	0.57055845791730841, -0.23523360389270459,
+	//h
+	0.23523360389270459, 0.57055845791730841, 0.32518250026371026, -0.0954672077842601,
+	-0.060416104155354193, 0.024908749865890957,
+	//g
+	0.024908749865890957, 0.060416104155354193, -0.0954672077842601, -0.32518250026371026,
+	0.57055845791730841, -0.23523360389270459
+};
+
+static constexpr double daub4[] = {
+	//tH
+	0.16290171402561818, 0.50547285754565086, 0.44610006912319428, -0.019787513117908766,
+	-0.13225358368436949, 0.021808150237385266, 0.023251800535557192, -0.0074934946651271303,
+	//tG
+	-0.0074934946651271303, -0.023251800535557192, 0.021808150237385266, 0.13225358368436949,
+	-0.019787513117908766, -0.44610006912319428, 0.50547285754565086, -0.16290171402561818,
+	//h
+	0.16290171402561818, 0.50547285754565086, 0.44610006912319428, -0.019787513117908766,
+	-0.13225358368436949, 0.021808150237385266, 0.023251800535557192, -0.0074934946651271303,
+	//g
+	-0.0074934946651271303, -0.023251800535557192, 0.021808150237385266, 0.13225358368436949,
+	-0.019787513117908766, -0.44610006912319428, 0.50547285754565086, -0.16290171402561818
+};
+
+static constexpr double daub5[] = {
+	//tH
+	0.1132094912917304, 0.42697177135271058, 0.51216347213015556, 0.097883480673753645,
+	-0.17132835769132992, -0.022800565942047008, 0.054851329321076954, -0.0044134000543251855,
+	-0.0088959350509259984, 0.0023587139692007549,
+	//tG
+	0.0023587139692007549, 0.0088959350509259984, -0.0044134000543251855, -0.054851329321076954,
+	-0.022800565942047008, 0.17132835769132992, 0.097883480673753645, -0.51216347213015556,
+	0.42697177135271058, -0.1132094912917304,
+	//h
+	0.1132094912917304, 0.42697177135271058, 0.51216347213015556, 0.097883480673753645,
+	-0.17132835769132992, -0.022800565942047008, 0.054851329321076954, -0.0044134000543251855,
+	-0.0088959350509259984, 0.0023587139692007549,
+	//g
+	0.0023587139692007549, 0.0088959350509259984, -0.0044134000543251855, -0.054851329321076954,
+	-0.022800565942047008, 0.17132835769132992, 0.097883480673753645, -0.51216347213015556,
+	0.42697177135271058, -0.1132094912917304
+};
+
+static constexpr double daub6[] = {
+	//tH
+	0.078871216001434374, 0.34975190703756825, 0.53113187994121269, 0.22291566146505057,
+	-0.15999329944587423, -0.091759032030033397, 0.06894404648719725, 0.019461604853963546,
+	-0.022331874165475257, 0.00039162557603468598, 0.0033780311815050823, -0.00076176690258371489,
+	//tG
+	-0.00076176690258371489, -0.0033780311815050823, 0.00039162557603468598, 0.022331874165475257,
+	0.019461604853963546, -0.06894404648719725, -0.091759032030033397, 0.15999329944587423,
+	0.22291566146505057, -0.53113187994121269, 0.34975190703756825, -0.078871216001434374,
+	//h
+	0.078871216001434374, 0.34975190703756825, 0.53113187994121269, 0.22291566146505057,
+	-0.15999329944587423, -0.091759032030033397, 0.06894404648719725, 0.019461604853963546,
+	-0.022331874165475257, 0.00039162557603468598, 0.0033780311815050823, -0.00076176690258371489,
+	//g
+	-0.00076176690258371489, -0.0033780311815050823, 0.00039162557603468598, 0.022331874165475257,
+	0.019461604853963546, -0.06894404648719725, -0.091759032030033397, 0.15999329944587423,
+	0.22291566146505057, -0.53113187994121269, 0.34975190703756825, -0.078871216001434374
+};
+
+static constexpr double daub7[] = {
+	//tH
+	0.055049715372847974, 0.28039564181303811, 0.51557424581833156, 0.33218624110566031,
+	-0.10175691123173262, -0.15841750564054388, 0.050423232504853144, 0.057001722579856959,
+	-0.026891226294856064, -0.011719970782347914, 0.0088748961896170358, 0.00030375749775690675,
+	-0.0012739523590610917, 0.00025011342657945584,
+	//tG
+	0.00025011342657945584, 0.0012739523590610917, 0.00030375749775690675, -0.0088748961896170358,
+	-0.011719970782347914, 0.026891226294856064, 0.057001722579856959, -0.050423232504853144,
+	-0.15841750564054388, 0.10175691123173262, 0.33218624110566031, -0.51557424581833156,
+	0.28039564181303811, -0.055049715372847974,
+	//h
+	0.055049715372847974, 0.28039564181303811, 0.51557424581833156, 0.33218624110566031,
+	-0.10175691123173262, -0.15841750564054388, 0.050423232504853144, 0.057001722579856959,
+	-0.026891226294856064, -0.011719970782347914, 0.0088748961896170358, 0.00030375749775690675,
+	-0.0012739523590610917, 0.00025011342657945584,
+	//g
+	0.00025011342657945584, 0.0012739523590610917, 0.00030375749775690675, -0.0088748961896170358,
+	-0.011719970782347914, 0.026891226294856064, 0.057001722579856959, -0.050423232504853144,
+	-0.15841750564054388, 0.10175691123173262, 0.33218624110566031, -0.51557424581833156,
+	0.28039564181303811, -0.055049715372847974
+};
+
+static constexpr double daub8[] = {
+	//tH
+	0.038477811054059688, 0.22123362357624055, 0.47774307521437653, 0.41390826621166282,
+	-0.011192867666649804, -0.2008293163911069, 0.00033409704628193201, 0.091038178423454269,
+	-0.012281950523002688, -0.031175103325330741, 0.0098860796480837766, 0.0061844224095381553,
+	-0.0034438596281275995, -0.00027700227421325788, 0.00047761485533173302, -0.00008306863059851036,
+	//tG
+	-0.00008306863059851036, -0.00047761485533173302, -0.00027700227421325788, 0.0034438596281275995,
+	0.0061844224095381553, -0.0098860796480837766, -0.031175103325330741, 0.012281950523002688,
+	0.091038178423454269, -0.00033409704628193201, -0.2008293163911069, 0.011192867666649804,
+	0.41390826621166282, -0.47774307521437653, 0.22123362357624055, -0.038477811054059688,
+	//h
+	0.038477811054059688, 0.22123362357624055, 0.47774307521437653, 0.41390826621166282,
+	-0.011192867666649804, -0.2008293163911069, 0.00033409704628193201, 0.091038178423454269,
+	-0.012281950523002688, -0.031175103325330741, 0.0098860796480837766, 0.0061844224095381553,
+	-0.0034438596281275995, -0.00027700227421325788, 0.00047761485533173302, -0.00008306863059851036,
+	//g
+	-0.00008306863059851036, -0.00047761485533173302, -0.00027700227421325788, 0.0034438596281275995,
+	0.0061844224095381553, -0.0098860796480837766, -0.031175103325330741, 0.012281950523002688,
+	0.091038178423454269, -0.00033409704628193201, -0.2008293163911069, 0.011192867666649804,
+	0.41390826621166282, -0.47774307521437653, 0.22123362357624055, -0.038477811054059688
+};
+
+static constexpr double daub9[] = {
+	//tH
+	0.026925174794160414, 0.17241715192471294, 0.4276745321702829, 0.464772857172778,
+	0.094184774751120151, -0.20737588089628295, -0.06847677451090331, 0.10503417113713563,
+	0.021726337729904018, -0.047823632058818594, 0.00017744640673182261, 0.015812082926137231,
+	-0.0033398101132413806, -0.0030274802871512112, 0.0013064836401789368, 0.00016290733600968354,
+	-0.00017816487954739422, 0.00002782275679290904,
+	//tG
+	0.00002782275679290904, 0.00017816487954739422, 0.00016290733600968354, -0.0013064836401789368,
+	-0.0030274802871512112, 0.0033398101132413806, 0.015812082926137231, -0.00017744640673182261,
+	-0.047823632058818594, -0.021726337729904018, 0.10503417113713563, 0.06847677451090331,
+	-0.20737588089628295, -0.094184774751120151, 0.464772857172778, -0.4276745321702829,
+	0.17241715192471294, -0.026925174794160414,
+	//h
+	0.026925174794160414, 0.17241715192471294, 0.4276745321702829, 0.464772857172778,
+	0.094184774751120151, -0.20737588089628295, -0.06847677451090331, 0.10503417113713563,
+	0.021726337729904018, -0.047823632058818594, 0.00017744640673182261, 0.015812082926137231,
+	-0.0033398101132413806, -0.0030274802871512112, 0.0013064836401789368, 0.00016290733600968354,
+	-0.00017816487954739422, 0.00002782275679290904,
+	//g
+	0.00002782275679290904, 0.00017816487954739422, 0.00016290733600968354, -0.0013064836401789368,
+	-0.0030274802871512112, 0.0033398101132413806, 0.015812082926137231, -0.00017744640673182261,
+	-0.047823632058818594, -0.021726337729904018, 0.10503417113713563, 0.06847677451090331,
+	-0.20737588089628295, -0.094184774751120151, 0.464772857172778, -0.4276745321702829,
+	0.17241715192471294, -0.026925174794160414
+};
+
+static constexpr double daub10[] = {
+	//tH
+	0.018858578796396217, 0.13306109139686573, 0.37278753574266171, 0.48681405536610023,
+	0.19881887088439901, -0.17666810089647036, -0.13855493935993191, 0.090063724266657846,
+	0.065801493550702236, -0.050483285598005224, -0.020829624043845835, 0.023484907048409193,
+	0.002550218483932993, -0.0075895011676789057, 0.00098666268244216888, 0.0014088432949635897,
+	-0.00048497391995569743, -0.00008235450295380118, 0.00006617718319909406, -0.00000937920788831568,
+	//tG
+	-0.00000937920788831568, -0.00006617718319909406, -0.00008235450295380118, 0.00048497391995569743,
+	0.0014088432949635897, -0.00098666268244216888, -0.0075895011676789057, -0.002550218483932993,
+	0.023484907048409193, 0.020829624043845835, -0.050483285598005224, -0.065801493550702236,
+	0.090063724266657846, 0.13855493935993191, -0.17666810089647036, -0.19881887088439901,
+	0.48681405536610023, -0.37278753574266171, 0.13306109139686573, -0.018858578796396217,
+	//h
+	0.018858578796396217, 0.13306109139686573, 0.37278753574266171, 0.48681405536610023,
+	0.19881887088439901, -0.17666810089647036, -0.13855493935993191, 0.090063724266657846,
+	0.065801493550702236, -0.050483285598005224, -0.020829624043845835, 0.023484907048409193,
+	0.002550218483932993, -0.0075895011676789057, 0.00098666268244216888, 0.0014088432949635897,
+	-0.00048497391995569743, -0.00008235450295380118, 0.00006617718319909406, -0.00000937920788831568,
+	//g
+	-0.00000937920788831568, -0.00006617718319909406, -0.00008235450295380118, 0.00048497391995569743,
+	0.0014088432949635897, -0.00098666268244216888, -0.0075895011676789057, -0.002550218483932993,
+	0.023484907048409193, 0.020829624043845835, -0.050483285598005224, -0.065801493550702236,
+	0.090063724266657846, 0.13855493935993191, -0.17666810089647036, -0.19881887088439901,
+	0.48681405536610023, -0.37278753574266171, 0.13306109139686573, -0.018858578796396217
+};
+
+static constexpr double inter1[] = {
+	//tH
+	1.0,
+	//tG
+	0.0, 0.0, 0.25, -0.5,
+	0.25,
+	//h
+	0.25, 0.5, 0.25,
+	//g
+	1.0
+};
+
+static constexpr double inter2[] = {
+	//tH
+	1.0,
+	//tG
+	0.0, 0.0, -0.03125, 0.0,
+	0.28125, -0.5, 0.28125, 0.0,
+	-0.03125,
+	//h
+	-0.03125, 0.0, 0.28125, 0.5,
+	0.28125, 0.0, -0.03125,
+	//g
+	1.0
+};
+
+static constexpr double inter3[] = {
+	//tH
+	1.0,
+	//tG
+	0.0, 0.0, 0.005859375, 0.0,
+	-0.048828125, 0.0, 0.29296875, -0.5,
+	0.29296875, 0.0, -0.048828125, 0.0,
+	0.005859375,
+	//h
+	0.005859375, 0.0, -0.048828125, 0.0,
+	0.29296875, 0.5, 0.29296875, 0.0,
+	-0.048828125, 0.0, 0.005859375,
+	//g
+	1.0
+};
+
+static constexpr WAVELET_FILTER waveletFilters[] = {
+	{ "bior13.flt", { 6, 4, 2, 6 }, { 3, 2, 0, 2 }, bior13 },
+	{ "bior15.flt", { 10, 4, 2, 10 }, { 5, 2, 0, 4 }, bior15 },
+	{ "bior22.flt", { 5, 5, 3, 5 }, { 2, 2, 1, 1 }, bior22 },
+	{ "bior24.flt", { 9, 5, 3, 9 }, { 4, 2, 1, 3 }, bior24 },
+	{ "bior26.flt", { 13, 5, 3, 13 }, { 6, 2, 1, 5 }, bior26 },
+	{ "bior28.flt", { 17, 5, 3, 17 }, { 8, 2, 1, 7 }, bior28 },
+	{ "bior31.flt", { 4, 4, 4, 4 }, { 0, 0, 0, 0 }, bior31 },
+	{ "bior33.flt", { 8, 6, 4, 8 }, { 0, 0, 0, 0 }, bior33 },
+	{ "bior35.flt", { 12, 6, 4, 12 }, { 0, 0, 0, 0 }, bior35 },
+	{ "bior37.flt", { 16, 6, 4, 16 }, { 7, 0, 0, 6 }, bior37 },
+	{ "bior39.flt", { 20, 6, 4, 20 }, { 0, 0, 0, 0 }, bior39 },
+	{ "bior46.flt", { 15, 7, 5, 15 }, { 7, 3, 2, 6 }, bior46 },
+	{ "bior48.flt", { 19, 7, 5, 19 }, { 9, 3, 2, 8 }, bior48 },
+	{ "bior97.flt", { 9, 9, 7, 9 }, { 5, 5, 4, 4 }, bior97 },
+	{ "coif1.flt", { 6, 6, 6, 6 }, { 2, 2, 2, 2 }, coif1 },
+	{ "coif2.flt", { 12, 12, 12, 12 }, { 5, 5, 5, 5 }, coif2 },
+	{ "coif3.flt", { 18, 18, 18, 18 }, { 8, 8, 8, 8 }, coif3 },
+	{ "coif4.flt", { 24, 24, 24, 24 }, { 11, 11, 11, 11 }, coif4 },
+	{ "coif5.flt", { 30, 30, 30, 30 }, { 14, 14, 14, 14 }, coif5 },
+	{ "daub1.flt", { 2, 2, 2, 2 }, { 0, 0, 0, 0 }, daub1 },
+	{ "daub2.flt", { 4, 4, 4, 4 }, { 1, 1, 1, 1 }, daub2 },
+	{ "daub3.flt", { 6, 6, 6, 6 }, { 2, 2, 2, 2 }, daub3 },
+	{ "daub4.flt", { 8, 8, 8, 8 }, { 3, 3, 3, 3 }, daub4 },
+	{ "daub5.flt", { 10, 10, 10, 10 }, { 4, 4, 4, 4 }, daub5 },
+	{ "daub6.flt", { 12, 12, 12, 12 }, { 5, 5, 5, 5 }, daub6 },
+	{ "daub7.flt", { 14, 14, 14, 14 }, { 6, 6, 6, 6 }, daub7 },
+	{ "daub8.flt", { 16, 16, 16, 16 }, { 7, 7, 7, 7 }, daub8 },
+	{ "daub9.flt", { 18, 18, 18, 18 }, { 8, 8, 8, 8 }, daub9 },
+	{ "daub10.flt", { 20, 20, 20, 20 }, { 9, 9, 9, 9 }, daub10 },
+	{ "inter1.flt", { 1, 5, 3, 1 }, { 0, 3, 1, 0 }, inter1 },
+	{ "inter2.flt", { 1, 9, 7, 1 }, { 0, 5, 3, 0 }, inter2 },
+	{ "inter3.flt", { 1, 13, 11, 1 }, { 0, 7, 5, 0 }, inter3 }
+};
+
+const WAVELET_FILTER* FindWaveletFilter(const char *name)
+{
+	for (const WAVELET_FILTER &filter : waveletFilters) {
+		if (!strcmp(filter.name, name))
+			return &filter;
+	}
+	return nullptr;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+//wavelet filter banks of the filters directory compiled in: analysis tH, tG and synthesis h, g
+//with their centers, as the .flt files list them. Files in FastWaveletTransform::setFilterDir()
+//override these by name
+struct WAVELET_FILTER {
+	const char *name;                //file name, "daub2.flt"
+	int length[4];                   //tH, tG, h, g
+	int center[4];
+	const double *taps;              //tH, tG, h, g taps one after the other
+};
+
+const WAVELET_FILTER* FindWaveletFilter(const char *name);      //nullptr if not built in
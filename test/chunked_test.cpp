@@ -0,0 +1,99 @@
+// chunked_test.cpp : ChunkedAnnotator against the whole record run of Annotator on every lead of a
+// record, n26c by default, and on a 250 Hz synthetic ECG whose baseline scale is not a divisor of the
+// 2 sec filter windows. Chunk and overlap lengths include ones that are not multiples of 2 sec; the
+// beats and annotation rows must be those of the whole record, whatever the chunking and the getPTU
+// threads. returns the number of failed checks
+//
+//   cl /std:c++14 /O2 /EHsc /I..\EcgAnnotation chunked_test.cpp ..\EcgAnnotation\ChunkedAnnotator.cpp
+//      ..\EcgAnnotation\Annotator.cpp ..\EcgAnnotation\AnnotationTable.cpp ..\EcgAnnotation\QrsDetector.cpp
+//      ..\EcgAnnotation\ContinuousWaveletTransform.cpp ..\EcgAnnotation\FastWaveletTransform.cpp
+//      ..\EcgAnnotation\StreamingWaveletTransform.cpp ..\EcgAnnotation\StationaryWaveletTransform.cpp
+//      ..\EcgAnnotation\Denoise.cpp ..\EcgAnnotation\waveletfilters.cpp ..\EcgAnnotation\helper.cpp
+//      ..\EcgAnnotation\vectorops.cpp ..\EcgAnnotation\signal.cpp ..\EcgAnnotation\SignalReader.cpp
+//   chunked_test [record.dat]
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "ChunkedAnnotator.h"
+#include "SignalReader.h"
+
+//rows of b that differ from a, or the larger size difference
+static int compare(AnnotationView a, AnnotationView b)
+{
+	int differ = a.getSize() > b.getSize() ? a.getSize() - b.getSize() : b.getSize() - a.getSize();
+	const int size = a.getSize() < b.getSize() ? a.getSize() : b.getSize();
+	for (int i = 0; i < size; i++)
+		if (a.sample(i) != b.sample(i) || a.type(i) != b.type(i))
+			differ++;
+	return differ;
+}
+
+static const double settings[][2] = { { 300, 10 }, { 60, 10 }, { 60, 5 }, { 45, 5 }, { 30, 5 }, { 30, 4 }, { 37, 3 },
+                                      { 25.5, 2.5 } };
+
+//checks failed for one lead
+static int check(const char *name, const double *data, int length, double sampleRate)
+{
+	Annotator whole;
+	AnnotationTable *qrs = whole.getQRS(data, length, sampleRate);
+	if (!qrs) {
+		printf(" %s: no QRS complexes  FAILED\n", name);
+		return 1;
+	}
+	whole.getEctopia(*qrs, sampleRate);
+	const AnnotationView rows = whole.getPTU(data, length, sampleRate, *qrs) ? whole.getAnnotation() : AnnotationView(*qrs);
+	printf(" %s: %d beats, %d rows\n", name, whole.getQRSNumber(), rows.getSize());
+
+	int failed = 0;
+	for (const double *setting : settings) {
+		for (int threads = 1; threads <= 4; threads += 3) {
+			ChunkedAnnotator chunked;
+			chunked.setChunk(setting[0], setting[1]);
+			chunked.setThreads(threads);
+			const int beats = chunked.annotate(data, length, sampleRate);
+			const int differ = compare(rows, chunked.getAnnotation());
+
+			const bool ok = beats == whole.getQRSNumber() && differ == 0;
+			printf("   chunk %5.1lf overlap %4.1lf threads %d: %d beats, %d rows differ  %s\n", setting[0], setting[1],
+			       threads, beats, differ, ok ? "ok" : "FAILED");
+			if (!ok) failed++;
+		}
+	}
+	return failed;
+}
+
+int main(int argc, char* argv[])
+{
+	const char *name = argc > 1 ? argv[1] : "../EcgAnnotation/data/n26c.dat";
+	Signal *signal = SignalReader::read(name);
+	if (!signal) {
+		printf(" failed to read %s\n", name);
+		return 1;
+	}
+
+	int failed = 0;
+	char lead[32];
+	for (int l = 0; l < signal->GetLeadsNum(); l++) {
+		sprintf(lead, "lead %d", l);
+		failed += check(lead, signal->GetData(l), signal->GetLength(l), signal->GetSR(l));
+	}
+	delete signal;
+
+	//20 min at 75 bpm with baseline wander and noise
+	const double sampleRate = 250.0;
+	const double pi = 3.14159265358979323846;
+	std::vector<double> ecg(size_t(20 * 60 * sampleRate));
+	for (int i = 0; i < int(ecg.size()); i++) {
+		const double t = i / sampleRate;
+		const double phase = fmod(t, 0.8);
+		const unsigned noise = unsigned(i) * 2654435761u;
+		ecg[i] = 1.5 * exp(-pow((phase - 0.3) / 0.012, 2)) - 0.3 * exp(-pow((phase - 0.33) / 0.01, 2)) +
+		         0.3 * exp(-pow((phase - 0.55) / 0.05, 2)) + 0.15 * exp(-pow((phase - 0.18) / 0.03, 2)) +
+		         0.2 * sin(2 * pi * 0.3 * t) + 0.02 * (((noise >> 8) % 1000) / 1000.0 - 0.5);
+	}
+	failed += check("synthetic 250 Hz", ecg.data(), int(ecg.size()), sampleRate);
+
+	printf(failed ? " %d checks failed\n" : " all checks passed\n", failed);
+	return failed;
+}
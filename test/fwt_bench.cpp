@@ -0,0 +1,48 @@
+// fwt_bench.cpp : FastWaveletTransform transform(10) + synthesis(10) wall clock, best of 3 runs,
+// for 10M and 2^24 samples with the lifting and the convolution paths.
+//
+//   cl /std:c++14 /O2 /EHsc /I..\EcgAnnotation fwt_bench.cpp ..\EcgAnnotation\FastWaveletTransform.cpp
+//      ..\EcgAnnotation\waveletfilters.cpp ..\EcgAnnotation\vectorops.cpp
+//   fwt_bench [filters dir]
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "FastWaveletTransform.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		FastWaveletTransformBase::setFilterDir(argv[1]);
+
+	const int sizes[] = { 10000000, 16777216 };
+	const char *filters[] = { "daub2.flt", "bior97.flt", "bior13.flt" };
+	for (int size : sizes) {
+		std::vector<double> data(size_t(size), 0.0);
+		for (int i = 0; i < size; i++)
+			data[i] = sin(i * 0.001) + 0.1 * sin(i * 0.37);
+
+		for (const char *filter : filters) {
+			for (int lifting = 1; lifting >= 0; lifting--) {
+				double best = 1e30;
+				for (int run = 0; run < 3; run++) {
+					FastWaveletTransform fwt;
+					if (!fwt.init(data.data(), size, filter, lifting != 0)) {
+						printf(" failed to load %s\n", filter);
+						return 1;
+					}
+					fwt.GetJNumbers(10, size);
+
+					const auto start = std::chrono::steady_clock::now();
+					fwt.transform(10);
+					fwt.synthesis(10);
+					best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+				}
+				printf("%9d %-10s %-11s %6.0f ms\n", size, filter, lifting ? "lifting" : "convolution", best);
+			}
+		}
+	}
+	return 0;
+}
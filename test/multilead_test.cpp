@@ -0,0 +1,180 @@
+// multilead_test.cpp : MultiLeadAnnotator beat fusion on n26c (2 leads) and on synthetic 250 Hz
+// records with a noisy lead of false and missed beats. The consensus must keep the beats of the
+// clean leads, vote out the false ones and not depend on the lead workers. returns the number of
+// failed checks
+//
+//   cl /std:c++14 /O2 /EHsc /I..\EcgAnnotation multilead_test.cpp ..\EcgAnnotation\MultiLeadAnnotator.cpp
+//      ..\EcgAnnotation\Annotator.cpp ..\EcgAnnotation\AnnotationTable.cpp ..\EcgAnnotation\QrsDetector.cpp
+//      ..\EcgAnnotation\ContinuousWaveletTransform.cpp ..\EcgAnnotation\FastWaveletTransform.cpp
+//      ..\EcgAnnotation\StreamingWaveletTransform.cpp ..\EcgAnnotation\StationaryWaveletTransform.cpp
+//      ..\EcgAnnotation\Denoise.cpp ..\EcgAnnotation\waveletfilters.cpp ..\EcgAnnotation\helper.cpp
+//      ..\EcgAnnotation\vectorops.cpp ..\EcgAnnotation\signal.cpp ..\EcgAnnotation\SignalReader.cpp
+//   multilead_test [record.dat]
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "MultiLeadAnnotator.h"
+#include "SignalReader.h"
+
+static const double sampleRate = 250.0;
+static const double period = 0.8;                //75 bpm, R peak at 0.3 sec of the period
+static const int length = 400000;                //1600 sec, 2000 beats
+
+static int failed = 0;
+
+static void expect(bool ok, const char *what)
+{
+	printf("   %-58s %s\n", what, ok ? "ok" : "FAILED");
+	if (!ok) failed++;
+}
+
+//clean leads shifted by lead samples, noisy one with wideband noise and spikes
+static double* synthetic(int lead, bool noisy)
+{
+	const double pi = 3.14159265358979323846;
+	double *data = new double[length];
+	unsigned state = 77u + unsigned(lead);
+	for (int i = 0; i < length; i++) {
+		const double t = (i + 2 * lead) / sampleRate;
+		const double phase = fmod(t, period);
+		const unsigned noise = unsigned(i) * 2654435761u;
+		data[i] = (1.5 - 0.3 * lead) * exp(-pow((phase - 0.3) / 0.012, 2)) - 0.3 * exp(-pow((phase - 0.33) / 0.01, 2)) +
+		          0.3 * exp(-pow((phase - 0.55) / 0.05, 2)) + 0.15 * exp(-pow((phase - 0.18) / 0.03, 2)) +
+		          0.2 * sin(2 * pi * 0.3 * t) + 0.02 * (((noise >> 8) % 1000) / 1000.0 - 0.5);
+		if (noisy) {
+			state = state * 1103515245u + 12345u;
+			data[i] += 1.2 * (((state >> 9) % 1000) / 1000.0 - 0.5);
+			if (i % 7919 < 3)
+				data[i] += 3.0;
+		}
+	}
+	return data;
+}
+
+static Signal* syntheticSignal(int leads, int noisyLead)
+{
+	Signal *signal = new Signal();
+	for (int lead = 0; lead < leads; lead++) {
+		DATA_HEADER hdr;
+		memset(&hdr, 0, sizeof(DATA_HEADER));
+		hdr.size = length;
+		hdr.sr = float(sampleRate);
+		hdr.lead = (unsigned char)lead;
+		hdr.bits = 12;
+		hdr.umv = 200;
+		signal->addSeries(hdr, synthetic(lead, lead == noisyLead));
+	}
+	return signal;
+}
+
+//QRS onsets outside [low, high] sec of the period; the Q wave onsets of the synthetic beats are at
+//0.27-0.28 sec, beats more than the 0.1 sec tolerance off are false
+static int outside(AnnotationView qrs, double low, double high)
+{
+	int count = 0;
+	for (int i = 0; i < qrs.getSize(); i += 2) {
+		const double phase = fmod(qrs.sample(i) / sampleRate, period);
+		if (phase < low || phase > high)
+			count++;
+	}
+	return count;
+}
+
+static int misplaced(AnnotationView qrs)
+{
+	return outside(qrs, 0.22, 0.32);
+}
+
+static int falseBeats(AnnotationView qrs)
+{
+	return outside(qrs, 0.17, 0.38);
+}
+
+static bool same(AnnotationView a, AnnotationView b)
+{
+	if (a.getSize() != b.getSize())
+		return false;
+	for (int i = 0; i < a.getSize(); i++)
+		if (a.sample(i) != b.sample(i) || a.type(i) != b.type(i))
+			return false;
+	return true;
+}
+
+//consensus and lead annotations of 1 and 4 lead workers
+static void checkThreads(Signal *signal)
+{
+	MultiLeadAnnotator one, four;
+	one.setThreads(1);
+	four.setThreads(4);
+	one.annotate(signal);
+	four.annotate(signal);
+
+	bool ok = same(one.getQRSAnnotation(), four.getQRSAnnotation()) && one.getVotes() == four.getVotes();
+	for (int lead = 0; lead < signal->GetLeadsNum(); lead++)
+		ok = ok && same(one.getLeadAnnotation(lead), four.getLeadAnnotation(lead));
+	expect(ok, "1 and 4 lead workers identical");
+}
+
+int main(int argc, char* argv[])
+{
+	char what[128];
+
+	const char *name = argc > 1 ? argv[1] : "../EcgAnnotation/data/n26c.dat";
+	Signal *signal = SignalReader::read(name);
+	if (!signal) {
+		printf(" failed to read %s\n", name);
+		return 1;
+	}
+	{
+		MultiLeadAnnotator fused, any;
+		fused.annotate(signal);
+		any.setVotes(1);
+		any.annotate(signal);
+		const int lead0 = fused.getLeadQRSAnnotation(0).getSize() / 2;
+		const int lead1 = fused.getLeadQRSAnnotation(1).getSize() / 2;
+		printf(" %s: leads %d, %d beats, consensus %d, any lead %d\n", name, lead0, lead1, fused.getQRSNumber(),
+		       any.getQRSNumber());
+
+		bool both = true;
+		for (size_t i = 0; i < fused.getVotes().size(); i++)
+			both = both && fused.getVotes()[i] == 2;
+		expect(fused.getQRSNumber() > 0 && fused.getQRSNumber() <= std::min(lead0, lead1), "2 leads: consensus within each lead");
+		expect(both, "2 leads: every consensus beat found by both");
+		expect(any.getQRSNumber() >= std::max(lead0, lead1), "setVotes(1): union of the leads");
+		checkThreads(signal);
+	}
+	delete signal;
+
+	signal = syntheticSignal(3, 2);
+	{
+		MultiLeadAnnotator fused;
+		fused.annotate(signal);
+		const AnnotationView noisy = fused.getLeadQRSAnnotation(2);
+		printf(" synthetic 3 leads, lead 2 noisy: %d beats, %d false; consensus %d\n", noisy.getSize() / 2,
+		       falseBeats(noisy), fused.getQRSNumber());
+
+		expect(falseBeats(noisy) > 0, "noisy lead finds false beats");
+		sprintf(what, "consensus keeps the %d beats", length / int(period * sampleRate));
+		expect(fused.getQRSNumber() == length / int(period * sampleRate), what);
+		expect(misplaced(fused.getQRSAnnotation()) == 0, "consensus onsets at the median of 3 leads");
+		checkThreads(signal);
+	}
+	delete signal;
+
+	signal = syntheticSignal(2, 1);
+	{
+		MultiLeadAnnotator fused, any;
+		fused.annotate(signal);
+		any.setVotes(1);
+		any.annotate(signal);
+		printf(" synthetic 2 leads, lead 1 noisy: consensus %d, any lead %d\n", fused.getQRSNumber(), any.getQRSNumber());
+
+		expect(falseBeats(fused.getQRSAnnotation()) == 0, "consensus votes out the false beats");
+		expect(falseBeats(any.getQRSAnnotation()) > 0, "setVotes(1) keeps them");
+	}
+	delete signal;
+
+	printf(failed ? " %d checks failed\n" : " all checks passed\n", failed);
+	return failed;
+}